@@ -0,0 +1,90 @@
+#ifndef PROCESS_COMMAND_TEMPLATE_HPP
+#define PROCESS_COMMAND_TEMPLATE_HPP
+
+#include <detail/process.hpp>
+#include <detail/process_launcher.hpp>
+#include <tuple>
+
+namespace PROCESS_NAMESPACE
+{
+
+#if defined(__unix__)
+
+// A command that gets launched repeatedly. The executable gets resolved (bare names through PATH), the argv block built
+// and the initializers checked once, so a launch only needs to fork & exec.
+// The initializers passed in here get applied to every launch, i.e. a process_env builds its block only once.
+template<detail::process_initializer<default_process_launcher> ... Inits>
+class command_template
+{
+    std::filesystem::path _exe;
+    detail::process::api::argv_buffer _argv;
+    std::tuple<Inits...> _inits;
+
+    static std::filesystem::path _resolve(const std::filesystem::path & exe)
+    {
+        auto res = detail::process::api::resolve_executable(exe);
+        if (res.is_relative())
+            res = std::filesystem::absolute(res);
+        if (::access(res.c_str(), X_OK) == -1)
+            detail::process::throw_last_error("executable not accessible", res);
+        return res;
+    }
+
+    template<typename ... More>
+    process _launch(char * const * argv, More && ... more)
+    {
+        return std::apply(
+                [&](auto & ... inits)
+                {
+                    return detail::process::api::default_process_launcher{}.launch_prepared(
+                            _exe, argv, inits..., std::forward<More>(more)...);
+                }, _inits);
+    }
+
+public:
+    template<typename Args>
+    command_template(const std::filesystem::path & exe, Args && args, Inits ... inits)
+        : _exe(_resolve(exe)), _argv(_exe.native(), std::forward<Args>(args)), _inits(std::move(inits)...)
+    {
+    }
+
+    command_template(const std::filesystem::path & exe, std::initializer_list<std::string_view> args, Inits ... inits)
+        : _exe(_resolve(exe)), _argv(_exe.native(), args), _inits(std::move(inits)...)
+    {
+    }
+
+    command_template(const command_template & ) = delete;
+    command_template(command_template && ) = default;
+    command_template& operator=(const command_template & ) = delete;
+    command_template& operator=(command_template && ) = default;
+
+    // The resolved executable.
+    const std::filesystem::path & exe() const { return _exe; }
+
+    // Launch the command, additional initializers are applied after the ones of the template.
+    template<detail::process_initializer<default_process_launcher> ... More>
+    process launch(More && ... more)
+    {
+        return _launch(_argv.data(), std::forward<More>(more)...);
+    }
+
+    // Launch the command with extra arguments appended.
+    template<detail::process_initializer<default_process_launcher> ... More>
+    process launch(std::initializer_list<std::string_view> extra_args, More && ... more)
+    {
+        detail::process::api::argv_buffer argv{_argv.data(), extra_args};
+        return _launch(argv.data(), std::forward<More>(more)...);
+    }
+};
+
+template<typename Args, typename ... Inits>
+command_template(const std::filesystem::path &, Args &&, Inits ...) -> command_template<Inits...>;
+
+template<typename ... Inits>
+command_template(const std::filesystem::path &, std::initializer_list<std::string_view>, Inits ...) -> command_template<Inits...>;
+
+#endif
+
+}
+
+#endif //PROCESS_COMMAND_TEMPLATE_HPP
@@ -113,6 +113,8 @@ public:
 
     // Attach to an existing process
     explicit process(const pid_type& pid) : _process_handle{pid} {}
+    // Take ownership of a handle obtained by a launcher
+    explicit process(detail::process::api::process_handle && handle) : _process_handle{std::move(handle)} {}
     // An empty process is similar to a default constructed thread. It holds an empty
     // handle and is a place holder for a process that is to be launched later.
     process() = default;
@@ -135,7 +137,8 @@ public:
     }
     // tbd behavior
     ~process() {
-        if (_attached && !_terminated)
+        // don't signal a pid we already reaped, it might have been reused.
+        if (_attached && !_terminated && _exit_status.load() == detail::process::api::still_active)
             _process_handle.terminate_if_running();
     }
     // Accessors
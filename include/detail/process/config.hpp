@@ -23,6 +23,10 @@ namespace PROCESS_NAMESPACE::detail::process
 #define DEFAULT_PIPE_SIZE 1024
 #endif
 
+#if !defined(DEFAULT_ARGV_BUFFER_SIZE)
+#define DEFAULT_ARGV_BUFFER_SIZE 1024
+#endif
+
 #if defined(__unix__)
 namespace posix {namespace extensions {}}
 namespace api = posix;
@@ -0,0 +1,123 @@
+#ifndef DETAIL_PROCESS_POSIX_ARGV_BUFFER_HPP
+#define DETAIL_PROCESS_POSIX_ARGV_BUFFER_HPP
+
+#include <detail/process/config.hpp>
+#include <cstring>
+#include <memory>
+#include <ranges>
+#include <string_view>
+
+namespace PROCESS_NAMESPACE::detail::process::posix {
+
+// A null terminated argv in a single block: the pointer table followed by the null terminated strings.
+// Arguments are copied, so string_views that aren't null terminated are fine.
+// Commands that fit into Size bytes don't allocate at all.
+template<std::size_t Size = DEFAULT_ARGV_BUFFER_SIZE>
+class basic_argv_buffer
+{
+    alignas(char*) char _small[Size];
+    std::unique_ptr<char[]> _large;
+    char ** _argv = nullptr;
+    std::size_t _count = 0u; // number of arguments, without the terminating nullptr
+    std::size_t _size  = 0u; // bytes used
+
+    template<typename Args>
+    static std::size_t _count_args(Args & args)
+    {
+        std::size_t res = 0u;
+        for (auto && a : args)
+            res += std::string_view(a).size() + 1u;
+        return res;
+    }
+
+    char * _allocate(std::size_t count, std::size_t chars)
+    {
+        _count = count;
+        _size = (count + 1u) * sizeof(char*) + chars;
+        char * mem = _small;
+        if (_size > Size)
+        {
+            _large.reset(new char[_size]);
+            mem = _large.get();
+        }
+        _argv = reinterpret_cast<char**>(mem);
+        _argv[count] = nullptr;
+        return mem + (count + 1u) * sizeof(char*);
+    }
+
+    char * _append(std::size_t idx, char * pos, std::string_view sv)
+    {
+        _argv[idx] = pos;
+        std::memcpy(pos, sv.data(), sv.size());
+        pos[sv.size()] = '\0';
+        return pos + sv.size() + 1u;
+    }
+
+    // The pointers refer into the buffer, so they need to get rebased if it's the internal one.
+    void _take(basic_argv_buffer & lhs) noexcept
+    {
+        _large = std::move(lhs._large);
+        _argv  = lhs._argv;
+        _count = lhs._count;
+        _size  = lhs._size;
+        if (reinterpret_cast<char*>(lhs._argv) == lhs._small)
+        {
+            std::memcpy(_small, lhs._small, _size);
+            _argv = reinterpret_cast<char**>(_small);
+            for (std::size_t i = 0u; i < _count; i++)
+                _argv[i] = _small + (_argv[i] - lhs._small);
+        }
+        lhs._argv = nullptr;
+        lhs._count = lhs._size = 0u;
+    }
+
+public:
+    // argv made up of exe followed by args.
+    template<typename Args>
+    basic_argv_buffer(std::string_view exe, Args && args)
+    {
+        auto pos = _allocate(std::ranges::size(args) + 1u, exe.size() + 1u + _count_args(args));
+        pos = _append(0u, pos, exe);
+        std::size_t idx = 1u;
+        for (auto && a : args)
+            pos = _append(idx++, pos, std::string_view(a));
+    }
+
+    // argv made up of an existing argv followed by args.
+    template<typename Args>
+    basic_argv_buffer(const char * const * prefix, Args && args)
+    {
+        std::size_t count = 0u, chars = 0u;
+        for (; prefix[count] != nullptr; count++)
+            chars += std::strlen(prefix[count]) + 1u;
+
+        auto pos = _allocate(count + std::ranges::size(args), chars + _count_args(args));
+        std::size_t idx = 0u;
+        for (; idx < count; idx++)
+            pos = _append(idx, pos, prefix[idx]);
+        for (auto && a : args)
+            pos = _append(idx++, pos, std::string_view(a));
+    }
+
+    basic_argv_buffer(const basic_argv_buffer & ) = delete;
+    basic_argv_buffer& operator=(const basic_argv_buffer & ) = delete;
+
+    basic_argv_buffer(basic_argv_buffer && lhs) noexcept { _take(lhs); }
+    basic_argv_buffer& operator=(basic_argv_buffer && lhs) noexcept
+    {
+        if (this != &lhs)
+            _take(lhs);
+        return *this;
+    }
+
+    char * const * data() const { return _argv; }
+    std::size_t size() const    { return _count; }
+    // Whether the arguments fit into the internal buffer.
+    bool is_small() const       { return !_large; }
+};
+
+using argv_buffer = basic_argv_buffer<>;
+
+}
+
+#endif //DETAIL_PROCESS_POSIX_ARGV_BUFFER_HPP
@@ -0,0 +1,278 @@
+#ifndef DETAIL_PROCESS_POSIX_CHILD_REAPER_HPP
+#define DETAIL_PROCESS_POSIX_CHILD_REAPER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <wait.h>
+#include <asio/signal_set.hpp>
+#include <asio/execution_context.hpp>
+#include <asio/execution/context.hpp>
+#include <asio/query.hpp>
+
+namespace PROCESS_NAMESPACE::detail::process::posix {
+
+// Process wide registry of children watched for exit, used when pidfds are not available.
+// A single reap() collects every exited watched child and dispatches its waiters,
+// so a SIGCHLD costs O(exited) waitid calls instead of one waitpid per pending waiter.
+// Statuses obtained elsewhere (e.g. by a blocking wait) get published here too,
+// so that a pid reaped by one party is still visible to everyone else.
+class child_reaper
+{
+public:
+    // Called with the native exit status, or an error (e.g. operation_aborted).
+    using waiter = std::function<void(std::error_code, int)>;
+
+    static child_reaper & instance()
+    {
+        static child_reaper reaper;
+        return reaper;
+    }
+
+    // Whether any pid is watched at all, allows to skip the lock.
+    bool empty() const { return _size.load(std::memory_order_acquire) == 0u; }
+
+    // Start watching a new child, e.g. one that is not ours and gets published by someone else.
+    void watch(pid_t pid)
+    {
+        std::lock_guard lock{_mutex};
+        _children.insert_or_assign(pid, entry{});
+        _size.store(_children.size(), std::memory_order_release);
+    }
+
+    // Invoke w once pid exited. If the status is already known, w is invoked immediately.
+    void async_wait(pid_t pid, waiter w)
+    {
+        std::unique_lock lock{_mutex};
+        auto & e = _entry(pid);
+        if (!_is_running(e.status))
+        {
+            const auto status = e.status;
+            lock.unlock();
+            w({}, status);
+        }
+        else
+            e.waiters.push_back(std::move(w));
+    }
+
+    // Abort all pending waiters of pid.
+    void cancel(pid_t pid)
+    {
+        std::vector<waiter> ws;
+        {
+            std::lock_guard lock{_mutex};
+            auto itr = _children.find(pid);
+            if (itr == _children.end())
+                return;
+            ws = std::move(itr->second.waiters);
+        }
+        for (auto & w : ws)
+            w(std::make_error_code(std::errc::operation_canceled), 0);
+    }
+
+    // Get the status of pid if it is watched, which is still_active until it gets published.
+    std::optional<int> status(pid_t pid)
+    {
+        if (empty())
+            return std::nullopt;
+        std::lock_guard lock{_mutex};
+        auto itr = _children.find(pid);
+        if (itr == _children.end())
+            return std::nullopt;
+        return itr->second.status;
+    }
+
+    // Block until the status of pid gets published. Returns nullopt if pid isn't watched.
+    std::optional<int> wait(pid_t pid)
+    {
+        if (empty())
+            return std::nullopt;
+        std::unique_lock lock{_mutex};
+        for (;;)
+        {
+            auto itr = _children.find(pid);
+            if (itr == _children.end())
+                return std::nullopt;
+            if (!_is_running(itr->second.status))
+                return itr->second.status;
+            _published.wait(lock);
+        }
+    }
+
+    // Publish the status of pid, if it is watched. Used if the child got reaped elsewhere.
+    void publish(pid_t pid, int status)
+    {
+        if (empty())
+            return;
+        std::vector<waiter> ws;
+        {
+            std::lock_guard lock{_mutex};
+            auto itr = _children.find(pid);
+            if (itr == _children.end())
+                return;
+            itr->second.status = status;
+            ws = std::move(itr->second.waiters);
+        }
+        _published.notify_all();
+        for (auto & w : ws)
+            w({}, status);
+    }
+
+    // Stop watching pid, e.g. because its handle got destroyed.
+    void forget(pid_t pid)
+    {
+        if (empty())
+            return;
+        std::lock_guard lock{_mutex};
+        if (_children.erase(pid) > 0u)
+            _size.store(_children.size(), std::memory_order_release);
+        _published.notify_all();
+    }
+
+    // Reap every watched child that exited and dispatch its waiters.
+    void reap()
+    {
+        if (empty())
+            return;
+
+        std::vector<std::pair<waiter, int>> ready;
+        {
+            std::lock_guard lock{_mutex};
+            bool foreign = false;
+            // Peek at the next zombie and reap it if it's ours, so we only touch children that actually exited.
+            for (;;)
+            {
+                siginfo_t info{};
+                if (::waitid(P_ALL, 0, &info, WEXITED | WNOHANG | WNOWAIT) == -1 || info.si_pid == 0)
+                    break;
+
+                auto itr = _children.find(info.si_pid);
+                if (itr == _children.end() || !_is_running(itr->second.status))
+                {
+                    // A zombie we don't own (e.g. a process_group member) hides all others from waitid(P_ALL)
+                    foreign = true;
+                    break;
+                }
+                if (!_reap(itr->first, itr->second, ready))
+                    break;
+            }
+            if (foreign)
+                for (auto & [pid, e] : _children)
+                    if (_is_running(e.status))
+                        _reap(pid, e, ready);
+        }
+        _published.notify_all();
+
+        for (auto & [w, status] : ready)
+            w({}, status);
+    }
+
+private:
+    struct entry
+    {
+        int status = 0x017f; // still_active
+        std::vector<waiter> waiters;
+    };
+
+    std::mutex _mutex;
+    std::condition_variable _published;
+    std::atomic<std::size_t> _size{0u};
+    std::unordered_map<pid_t, entry> _children;
+
+    static bool _is_running(int code) { return !WIFEXITED(code) && !WIFSIGNALED(code); }
+
+    entry & _entry(pid_t pid)
+    {
+        auto & e = _children[pid];
+        _size.store(_children.size(), std::memory_order_release);
+        return e;
+    }
+
+    static bool _reap(pid_t pid, entry & e, std::vector<std::pair<waiter, int>> & ready)
+    {
+        int status = 0;
+        const auto ret = ::waitpid(pid, &status, WNOHANG);
+        if (ret != pid || _is_running(status))
+            return false;
+
+        e.status = status;
+        for (auto & w : e.waiters)
+            ready.emplace_back(std::move(w), status);
+        e.waiters.clear();
+        return true;
+    }
+};
+
+// Per execution context listener for SIGCHLD, that drives the child_reaper.
+// It only listens while it has pending waiters, so it doesn't keep the context from running out of work.
+class sigchld_service : public asio::execution_context::service
+{
+    std::mutex _mutex;
+    std::optional<asio::signal_set> _sset;
+    std::size_t _waiters = 0u;
+    bool _armed = false;
+
+    // requires _mutex to be locked.
+    void _arm()
+    {
+        _armed = true;
+        _sset->async_wait(
+                [this](std::error_code ec, int)
+                {
+                    if (!ec)
+                        child_reaper::instance().reap();
+
+                    std::lock_guard lock{_mutex};
+                    if (_sset && _waiters > 0u)
+                        _arm();
+                    else
+                        _armed = false;
+                });
+    }
+
+public:
+    inline static asio::execution_context::id id;
+
+    explicit sigchld_service(asio::execution_context & ctx) : asio::execution_context::service(ctx) {}
+
+    // Add a waiter & listen for SIGCHLD on exec, if not done yet.
+    template<typename Executor>
+    void listen(const Executor & exec)
+    {
+        std::lock_guard lock{_mutex};
+        _waiters++;
+        if (!_sset)
+            _sset.emplace(exec, SIGCHLD);
+        if (!_armed)
+            _arm();
+    }
+
+    // A waiter added by listen completed.
+    void done()
+    {
+        std::lock_guard lock{_mutex};
+        if (--_waiters == 0u && _armed && _sset)
+            _sset->cancel();
+    }
+
+    void shutdown() override
+    {
+        std::lock_guard lock{_mutex};
+        _sset.reset();
+    }
+};
+
+template<typename Executor>
+sigchld_service & use_sigchld_service(const Executor & exec)
+{
+    return asio::use_service<sigchld_service>(asio::query(exec, asio::execution::context));
+}
+
+}
+
+#endif //DETAIL_PROCESS_POSIX_CHILD_REAPER_HPP
@@ -0,0 +1,54 @@
+#ifndef DETAIL_PROCESS_POSIX_CLONE3_LAUNCHER_HPP
+#define DETAIL_PROCESS_POSIX_CLONE3_LAUNCHER_HPP
+
+#include <detail/process/posix/process_launcher.hpp>
+#include <detail/process/posix/pidfd.hpp>
+
+namespace PROCESS_NAMESPACE::detail::process::posix {
+
+// Launcher based on clone3(CLONE_PIDFD), so the process_handle holds a pidfd.
+// That allows waiting & signaling without racing with pid reuse.
+// If clone3 isn't available it falls back to fork & pidfd_open.
+//
+// Note that the child can't rely on pthread_atfork handlers, so on_exec_setup must stick
+// to async-signal-safe functions, as it should in a multi-threaded program anyhow.
+class clone3_process_launcher : public default_process_launcher
+{
+    bool _vfork = false;
+
+    pid_t _clone()
+    {
+        pidfd = -1;
+        pid_t res;
+#if defined(__linux__)
+        res = clone3(CLONE_PIDFD | (_vfork ? CLONE_VFORK : 0), &pidfd);
+        if (res != -1 || (errno != ENOSYS && errno != EINVAL && errno != EPERM))
+            return res;
+#endif
+        res = ::fork();
+        if (res > 0)
+            pidfd = pidfd_open(res);
+        return res;
+    }
+
+public:
+    // With vfork = true the parent is suspended until the child called exec or exited (CLONE_VFORK).
+    explicit clone3_process_launcher(bool vfork = false) : _vfork(vfork) {}
+
+    template<typename Args, typename ... Inits>
+    auto launch(const std::filesystem::path &exe, Args && args, Inits && ... inits) -> PROCESS_NAMESPACE::process
+    {
+        return _launch([this]{return _clone();}, exe, std::forward<Args>(args), std::forward<Inits>(inits)...);
+    }
+
+    template<typename Args, typename ... Inits>
+    auto launch(const executable_handle &exe, Args && args, Inits && ... inits) -> PROCESS_NAMESPACE::process
+    {
+        exe_fd = exe.native_handle();
+        return launch(exe.path(), std::forward<Args>(args), std::forward<Inits>(inits)...);
+    }
+};
+
+}
+
+#endif //DETAIL_PROCESS_POSIX_CLONE3_LAUNCHER_HPP
@@ -0,0 +1,136 @@
+#ifndef DETAIL_PROCESS_POSIX_EXECUTABLE_HANDLE_HPP
+#define DETAIL_PROCESS_POSIX_EXECUTABLE_HANDLE_HPP
+
+#include <detail/process/config.hpp>
+#include <detail/process/exception.hpp>
+#include <detail/process/posix/search_path.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace PROCESS_NAMESPACE::detail::process::posix {
+
+#if defined(__linux__)
+
+#if !defined(SYS_execveat)
+#define SYS_execveat 322
+#endif
+
+#if !defined(AT_EMPTY_PATH)
+#define AT_EMPTY_PATH 0x1000
+#endif
+
+#if !defined(MFD_EXEC)
+#define MFD_EXEC 0x0010U
+#endif
+
+// glibc only got a wrapper in 2.34
+inline int execveat(int dirfd, const char * path, char * const * argv, char * const * envp, int flags) noexcept
+{
+    return static_cast<int>(::syscall(SYS_execveat, dirfd, path, argv, envp, flags));
+}
+
+#endif
+
+// Execute the file referred to by fd, i.e. the equivalent of fexecve.
+inline int exec_fd(int fd, char * const * argv, char * const * envp) noexcept
+{
+#if defined(__linux__)
+    return execveat(fd, "", argv, envp, AT_EMPTY_PATH);
+#else
+    return ::fexecve(fd, argv, envp);
+#endif
+}
+
+// An executable opened once, that can be launched repeatedly without resolving its path again.
+// The launched binary is always the one that was opened, even if the file gets replaced or removed later on.
+//
+// Note that scripts can't be launched this way: the interpreter would get passed /dev/fd/N,
+// which is already closed, because the fd is close-on-exec.
+class executable_handle
+{
+    int _fd = -1;
+    std::filesystem::path _path;
+
+public:
+    // Open exe, bare names get looked up in PATH.
+    explicit executable_handle(const std::filesystem::path & exe) : _path(resolve_executable(exe))
+    {
+#if defined(O_PATH)
+        _fd = ::open(_path.c_str(), O_PATH | O_CLOEXEC);
+#else
+        _fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+        if (_fd == -1)
+            throw_last_error("open executable failed", _path);
+    }
+
+    // Take ownership of fd, path is used for argv[0] & error messages.
+    executable_handle(int fd, std::filesystem::path path) : _fd(fd), _path(std::move(path)) {}
+
+    executable_handle(const executable_handle & ) = delete;
+    executable_handle& operator=(const executable_handle & ) = delete;
+
+    executable_handle(executable_handle && lhs) noexcept
+        : _fd(std::exchange(lhs._fd, -1)), _path(std::move(lhs._path)) {}
+    executable_handle& operator=(executable_handle && lhs) noexcept
+    {
+        if (_fd != -1)
+            ::close(_fd);
+        _fd = std::exchange(lhs._fd, -1);
+        _path = std::move(lhs._path);
+        return *this;
+    }
+
+    ~executable_handle()
+    {
+        if (_fd != -1)
+            ::close(_fd);
+    }
+
+#if defined(__linux__)
+    // Load an executable image from memory into a sealed memfd, so it can be launched without touching the disk.
+    // name shows up in /proc/<pid>/exe & is used as argv[0].
+    static executable_handle from_memory(std::span<const std::byte> image, const std::string & name)
+    {
+        // kernels with vm.memfd_noexec need MFD_EXEC, older ones reject it.
+        int fd = ::memfd_create(name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING | MFD_EXEC);
+        if (fd == -1 && errno == EINVAL)
+            fd = ::memfd_create(name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (fd == -1)
+            throw_last_error("memfd_create failed", name);
+
+        executable_handle res{fd, name};
+        for (auto data = image; !data.empty();)
+        {
+            const auto n = ::write(fd, data.data(), data.size());
+            if (n == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw_last_error("write to memfd failed", name);
+            }
+            data = data.subspan(static_cast<std::size_t>(n));
+        }
+
+        // the image can't be modified anymore, i.e. every launch runs exactly what was loaded.
+        if (::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1)
+            throw_last_error("sealing memfd failed", name);
+        return res;
+    }
+#endif
+
+    int native_handle() const { return _fd; }
+    const std::filesystem::path & path() const { return _path; }
+};
+
+}
+
+#endif //DETAIL_PROCESS_POSIX_EXECUTABLE_HANDLE_HPP
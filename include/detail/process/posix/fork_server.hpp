@@ -0,0 +1,506 @@
+#ifndef DETAIL_PROCESS_POSIX_FORK_SERVER_HPP
+#define DETAIL_PROCESS_POSIX_FORK_SERVER_HPP
+
+#include <detail/process/posix/spawn_launcher.hpp>
+#include <detail/process/posix/child_reaper.hpp>
+#include <detail/process/posix/pidfd.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+
+namespace PROCESS_NAMESPACE::detail::process::posix {
+
+// A small helper process, forked at startup, that launches processes on our behalf.
+// Since it stays small & single threaded, the cost of a launch doesn't depend on the size of our process.
+//
+// Requests carry exe, argv, env, working directory & process group, the file descriptors
+// for the child are passed via SCM_RIGHTS. The server reports the pid & later the exit status,
+// which gets published through the child_reaper, since the children are not ours to wait for.
+//
+// It should be created before the process starts any threads.
+class fork_server
+{
+    enum message_type : std::int32_t
+    {
+        launched = 0,
+        exited   = 1
+    };
+
+    struct message
+    {
+        std::int32_t type;
+        std::int32_t pid;
+        std::int32_t value; // errno for launched, exit status for exited
+    };
+
+    struct request_header
+    {
+        std::uint32_t size;
+        std::uint32_t fd_count;
+    };
+
+    int _socket = -1;
+    pid_t _pid = -1;
+    std::thread _reader;
+
+    std::mutex _request_mutex; // one request in flight at a time
+
+    std::mutex _reply_mutex;
+    std::condition_variable _reply_cv;
+    std::optional<message> _reply;
+    bool _closed = false;
+
+    static bool _write_all(int fd, const void * data, std::size_t size)
+    {
+        auto p = static_cast<const char*>(data);
+        while (size > 0u)
+        {
+            const auto res = ::write(fd, p, size);
+            if (res == -1 && errno == EINTR)
+                continue;
+            else if (res <= 0)
+                return false;
+            p += res;
+            size -= res;
+        }
+        return true;
+    }
+
+    static bool _read_all(int fd, void * data, std::size_t size)
+    {
+        auto p = static_cast<char*>(data);
+        while (size > 0u)
+        {
+            const auto res = ::read(fd, p, size);
+            if (res == -1 && errno == EINTR)
+                continue;
+            else if (res <= 0)
+                return false;
+            p += res;
+            size -= res;
+        }
+        return true;
+    }
+
+    static bool _send_fds(int sock, const void * data, std::size_t size, const std::vector<int> & fds)
+    {
+        iovec iov{const_cast<void*>(data), size};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()));
+        if (!fds.empty())
+        {
+            msg.msg_control = control.data();
+            msg.msg_controllen = control.size();
+            auto cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type  = SCM_RIGHTS;
+            cmsg->cmsg_len   = CMSG_LEN(sizeof(int) * fds.size());
+            std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+        }
+
+        ssize_t res;
+        do
+            res = ::sendmsg(sock, &msg, MSG_NOSIGNAL);
+        while (res == -1 && errno == EINTR);
+        return res == static_cast<ssize_t>(size);
+    }
+
+    static bool _recv_fds(int sock, void * data, std::size_t size, std::vector<int> & fds)
+    {
+        iovec iov{data, size};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        char control[CMSG_SPACE(sizeof(int) * 64)];
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        ssize_t res;
+        do
+            res = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+        while (res == -1 && errno == EINTR);
+        if (res <= 0)
+            return false;
+
+        for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+            {
+                const auto n = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                const auto first = fds.size();
+                fds.resize(first + n);
+                std::memcpy(fds.data() + first, CMSG_DATA(cmsg), n * sizeof(int));
+            }
+
+        return static_cast<std::size_t>(res) == size ||
+               _read_all(sock, static_cast<char*>(data) + res, size - res);
+    }
+
+    // Reads the strings of a request, as written by request::serialize.
+    struct reader
+    {
+        const char * pos;
+        std::int32_t get_int()
+        {
+            std::int32_t res;
+            std::memcpy(&res, pos, sizeof(res));
+            pos += sizeof(res);
+            return res;
+        }
+        char * get_str()
+        {
+            auto res = const_cast<char*>(pos);
+            pos += std::strlen(pos) + 1;
+            return res;
+        }
+        std::vector<char*> get_strs()
+        {
+            std::vector<char*> res(get_int(), nullptr);
+            for (auto & r : res)
+                r = get_str();
+            res.push_back(nullptr);
+            return res;
+        }
+    };
+
+    // The server side, never returns.
+    [[noreturn]] static void _run(int sock)
+    {
+        sigset_t mask, old_mask;
+        ::sigemptyset(&mask);
+        ::sigaddset(&mask, SIGCHLD);
+        ::sigprocmask(SIG_BLOCK, &mask, &old_mask);
+        const int sfd = ::signalfd(-1, &mask, SFD_CLOEXEC | SFD_NONBLOCK);
+
+        const auto send = [&](message msg) { if (!_write_all(sock, &msg, sizeof(msg))) _exit(EXIT_FAILURE); };
+
+        pollfd pfds[2] = {{sock, POLLIN, 0}, {sfd, POLLIN, 0}};
+        for (;;)
+        {
+            if (::poll(pfds, sfd == -1 ? 1 : 2, sfd == -1 ? 100 : -1) == -1 && errno != EINTR)
+                _exit(EXIT_FAILURE);
+
+            if (sfd == -1 || pfds[1].revents & POLLIN)
+            {
+                signalfd_siginfo info;
+                while (sfd != -1 && ::read(sfd, &info, sizeof(info)) > 0);
+
+                int status;
+                pid_t pid;
+                while ((pid = ::waitpid(-1, &status, WNOHANG)) > 0)
+                    send({exited, pid, status});
+            }
+
+            if (!(pfds[0].revents & (POLLIN | POLLHUP)))
+                continue;
+
+            request_header header;
+            std::vector<int> fds;
+            if (!_recv_fds(sock, &header, sizeof(header), fds))
+                _exit(EXIT_SUCCESS); // our parent is gone
+
+            std::vector<char> payload(header.size);
+            if (!_read_all(sock, payload.data(), payload.size()))
+                _exit(EXIT_FAILURE);
+
+            reader rd{payload.data()};
+            const auto pgid = rd.get_int();
+            std::vector<int> targets(rd.get_int());
+            for (auto & t : targets)
+                t = rd.get_int();
+            const char * exe = rd.get_str();
+            const char * cwd = rd.get_str();
+            const auto argv = rd.get_strs();
+            const auto envp = rd.get_strs();
+
+            int p[2];
+            if (::pipe2(p, O_CLOEXEC) == -1)
+            {
+                send({launched, -1, errno});
+                continue;
+            }
+
+            const pid_t pid = ::fork();
+            if (pid == 0)
+            {
+                ::close(p[0]);
+                ::sigprocmask(SIG_SETMASK, &old_mask, nullptr);
+                int err = 0;
+                if (pgid != -1 && ::setpgid(0, pgid) == -1)
+                    err = errno;
+                for (std::size_t i = 0u; err == 0 && i < targets.size() && i < fds.size(); i++)
+                    if (::dup2(fds[i], targets[i]) == -1)
+                        err = errno;
+                if (err == 0 && *cwd != '\0' && ::chdir(cwd) == -1)
+                    err = errno;
+                if (err == 0)
+                {
+                    ::execve(exe, argv.data(), envp.data());
+                    err = errno;
+                }
+                _write_all(p[1], &err, sizeof(err));
+                _exit(EXIT_FAILURE);
+            }
+            const int fork_err = errno;
+            ::close(p[1]);
+            for (auto fd : fds)
+                ::close(fd);
+
+            int err = 0;
+            if (pid == -1)
+                err = fork_err;
+            else if (_read_all(p[0], &err, sizeof(err))) // exec failed, so we don't report the exit
+            {
+                int status;
+                ::waitpid(pid, &status, 0);
+            }
+            ::close(p[0]);
+            send({launched, err == 0 ? pid : -1, err});
+        }
+    }
+
+    void _read_messages()
+    {
+        auto & reaper = child_reaper::instance();
+        message msg;
+        while (_read_all(_socket, &msg, sizeof(msg)))
+        {
+            if (msg.type == exited)
+                reaper.publish(msg.pid, msg.value);
+            else
+            {
+                // watch it before any exit message for it can get read.
+                if (msg.pid > 0)
+                    reaper.watch(msg.pid);
+                std::lock_guard lock{_reply_mutex};
+                _reply = msg;
+                _reply_cv.notify_all();
+            }
+        }
+        std::lock_guard lock{_reply_mutex};
+        _closed = true;
+        _reply_cv.notify_all();
+    }
+
+public:
+    fork_server()
+    {
+        int socks[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, socks) == -1)
+            throw_last_error("socketpair() failed");
+
+        _pid = ::fork();
+        if (_pid == -1)
+        {
+            ::close(socks[0]);
+            ::close(socks[1]);
+            throw_last_error("fork() failed");
+        }
+        else if (_pid == 0)
+        {
+            ::close(socks[0]);
+            _run(socks[1]);
+        }
+        ::close(socks[1]);
+        _socket = socks[0];
+        _reader = std::thread{[this]{ _read_messages(); }};
+    }
+
+    fork_server(const fork_server & ) = delete;
+    fork_server& operator=(const fork_server & ) = delete;
+
+    // Shuts the server down, the children it launched keep running.
+    ~fork_server()
+    {
+        ::shutdown(_socket, SHUT_RDWR);
+        _reader.join();
+        ::close(_socket);
+        ::waitpid(_pid, nullptr, 0);
+    }
+
+    // The pid of the server itself.
+    pid_t id() const { return _pid; }
+
+    // Description of a process to launch.
+    struct request
+    {
+        const char * exe = nullptr;
+        char * const * argv = nullptr;
+        char * const * env = nullptr;
+        std::filesystem::path cwd;
+        pid_t pgid = -1; // -1 keeps the servers group, 0 creates a new one.
+        std::vector<int> fds;     // fds of the caller
+        std::vector<int> targets; // fd number they get in the child
+
+        std::vector<char> serialize() const
+        {
+            std::vector<char> res;
+            const auto put_int = [&](std::int32_t i)
+            {
+                const auto p = reinterpret_cast<const char*>(&i);
+                res.insert(res.end(), p, p + sizeof(i));
+            };
+            const auto put_str = [&](std::string_view sv)
+            {
+                res.insert(res.end(), sv.begin(), sv.end());
+                res.push_back('\0');
+            };
+            const auto put_strs = [&](char * const * p)
+            {
+                std::int32_t n = 0;
+                while (p && p[n] != nullptr)
+                    n++;
+                put_int(n);
+                for (auto i = 0; i < n; i++)
+                    put_str(p[i]);
+            };
+
+            put_int(pgid);
+            put_int(static_cast<std::int32_t>(targets.size()));
+            for (auto t : targets)
+                put_int(t);
+            put_str(exe);
+            put_str(cwd.native());
+            put_strs(argv);
+            put_strs(env);
+            return res;
+        }
+    };
+
+    // Launch a process, returns the pid or -1 and sets ec.
+    pid_t launch(const request & req, std::error_code & ec)
+    {
+        const auto payload = req.serialize();
+        const request_header header{static_cast<std::uint32_t>(payload.size()), static_cast<std::uint32_t>(req.fds.size())};
+
+        std::lock_guard request_lock{_request_mutex};
+        {
+            std::lock_guard lock{_reply_mutex};
+            _reply.reset();
+        }
+
+        if (!_send_fds(_socket, &header, sizeof(header), req.fds) ||
+            !_write_all(_socket, payload.data(), payload.size()))
+        {
+            ec = get_last_error();
+            return -1;
+        }
+
+        std::unique_lock lock{_reply_mutex};
+        _reply_cv.wait(lock, [&]{return _reply || _closed;});
+        if (!_reply)
+        {
+            ec = std::make_error_code(std::errc::broken_pipe);
+            return -1;
+        }
+        if (_reply->pid == -1)
+            ec = std::error_code(_reply->value, std::system_category());
+        return _reply->pid;
+    }
+};
+
+// Launcher that uses a fork_server. Initializers are supported if they are spawnable, i.e. provide on_spawn_setup.
+// Others need to run code in the child, which the server can't, so the launcher falls back to fork.
+class fork_server_launcher : public default_process_launcher
+{
+    fork_server & _server;
+    fork_server::request _request;
+
+    template<typename Initializer>
+    void _on_spawn_setup(Initializer &&initializer) {}
+
+    template<typename Initializer> requires on_spawn_setup_init<Initializer, fork_server_launcher>
+    void _on_spawn_setup(Initializer &&init) { init.on_spawn_setup(*this); }
+
+public:
+    explicit fork_server_launcher(fork_server & server) : _server(server) {}
+
+    // Pass fd to the child as new_fd.
+    void add_dup2(int fd, int new_fd)
+    {
+        _request.fds.push_back(fd);
+        _request.targets.push_back(new_fd);
+    }
+
+    // Change the working directory of the child.
+    void add_chdir(const std::filesystem::path & dir)
+    {
+        _request.cwd = dir;
+    }
+
+    // Put the child into the process group pgid, 0 creates a new group.
+    void set_pgroup(pid_t pgid)
+    {
+        _request.pgid = pgid;
+    }
+
+    // The fork server can't execute a file descriptor of ours, so this always uses fork.
+    template<typename Args, typename ... Inits>
+    auto launch(const executable_handle &exe, Args && args, Inits && ... inits) -> PROCESS_NAMESPACE::process
+    {
+        return default_process_launcher::launch(exe, std::forward<Args>(args), std::forward<Inits>(inits)...);
+    }
+
+    template<typename Args, typename ... Inits>
+    auto launch(const std::filesystem::path &exe, Args && args, Inits && ... inits) -> PROCESS_NAMESPACE::process
+    {
+        if constexpr (!(spawnable_init<Inits, fork_server_launcher> && ...))
+            return default_process_launcher::launch(exe, std::forward<Args>(args), std::forward<Inits>(inits)...);
+        else
+        {
+            auto arg_store = prepare_args(exe, std::forward<Args>(args));
+            cmd_line = arg_store.data();
+
+            (_on_setup(inits),...);
+            (_on_spawn_setup(inits),...);
+
+            if (_ec)
+            {
+                (_on_error(inits),...);
+                throw process_error(_ec, _error_msg, exe);
+            }
+
+            const auto path = resolve_executable(exe);
+            _request.exe = path.c_str();
+            _request.argv = cmd_line;
+            _request.env = env;
+
+            std::error_code ec;
+            pid = _server.launch(_request, ec);
+            if (ec)
+            {
+                set_error(ec, "fork_server launch failed");
+                (_on_error(inits),...);
+                throw process_error(_ec, _error_msg, exe);
+            }
+
+            // the child is not ours, but a pidfd still tells us when it's gone.
+            PROCESS_NAMESPACE::process proc{process_handle{pid, pidfd_open(pid)}};
+            (_on_success(inits),...);
+
+            if (_ec)
+            {
+                (_on_error(inits),...);
+                throw process_error(_ec, _error_msg, exe);
+            }
+
+            return proc;
+        }
+    }
+};
+
+}
+
+#endif //DETAIL_PROCESS_POSIX_FORK_SERVER_HPP
@@ -0,0 +1,80 @@
+#ifndef DETAIL_PROCESS_POSIX_PIDFD_HPP
+#define DETAIL_PROCESS_POSIX_PIDFD_HPP
+
+#include <cstdint>
+#include <csignal>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/sched.h>
+#endif
+
+// Thin wrappers around the pidfd syscalls, glibc only got wrappers for some of them recently.
+// All of them return -1 and set errno to ENOSYS if the system doesn't support them.
+
+namespace PROCESS_NAMESPACE::detail::process::posix {
+
+#if defined(__linux__)
+
+#if !defined(CLONE_PIDFD)
+#define CLONE_PIDFD 0x00001000
+#endif
+
+#if !defined(SYS_pidfd_open)
+#define SYS_pidfd_open 434
+#endif
+
+#if !defined(SYS_pidfd_send_signal)
+#define SYS_pidfd_send_signal 424
+#endif
+
+#if !defined(SYS_clone3)
+#define SYS_clone3 435
+#endif
+
+constexpr idtype_t p_pidfd = static_cast<idtype_t>(3);
+
+inline int pidfd_open(pid_t pid, unsigned int flags = 0) noexcept
+{
+    return static_cast<int>(::syscall(SYS_pidfd_open, pid, flags));
+}
+
+inline int pidfd_send_signal(int pidfd, int sig) noexcept
+{
+    return static_cast<int>(::syscall(SYS_pidfd_send_signal, pidfd, sig, nullptr, 0u));
+}
+
+// Like fork, but allows to pass in CLONE_* flags and obtain a pidfd.
+inline pid_t clone3(std::uint64_t flags, int * pidfd = nullptr) noexcept
+{
+    ::clone_args args{};
+    args.flags = flags;
+    args.pidfd = reinterpret_cast<std::uintptr_t>(pidfd);
+    args.exit_signal = SIGCHLD;
+    return static_cast<pid_t>(::syscall(SYS_clone3, &args, sizeof(args)));
+}
+
+#else
+
+inline int pidfd_open(pid_t, unsigned int = 0) noexcept { errno = ENOSYS; return -1; }
+inline int pidfd_send_signal(int, int) noexcept         { errno = ENOSYS; return -1; }
+
+#endif
+
+// Convert the result of waitid into a status as returned by waitpid.
+inline int status_from_siginfo(const siginfo_t & info)
+{
+    switch (info.si_code)
+    {
+        case CLD_EXITED: return (info.si_status & 0xff) << 8;
+        case CLD_KILLED: return info.si_status & 0x7f;
+        case CLD_DUMPED: return (info.si_status & 0x7f) | 0x80;
+        default: return 0x017f; // still_active
+    }
+}
+
+}
+
+#endif //DETAIL_PROCESS_POSIX_PIDFD_HPP
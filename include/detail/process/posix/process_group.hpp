@@ -117,6 +117,12 @@ struct group_ref
             ::setpgid(0, grp.grp);
     }
 
+    template <class SpawnLauncher>
+    void on_spawn_setup(SpawnLauncher& exec) const
+    {
+        exec.set_pgroup(grp.grp == -1 ? 0 : grp.grp);
+    }
+
     template <class Executor>
     void on_success(Executor& exec) const
     {
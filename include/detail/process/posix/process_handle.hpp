@@ -3,8 +3,13 @@
 
 #include <wait.h>
 #include <detail/process/exception.hpp>
+#include <detail/process/posix/pidfd.hpp>
+#include <detail/process/posix/child_reaper.hpp>
 #include <unistd.h>
-#include <asio/signal_set.hpp>
+#include <fcntl.h>
+#include <asio/post.hpp>
+#include <asio/executor_work_guard.hpp>
+#include <asio/posix/stream_descriptor.hpp>
 
 namespace PROCESS_NAMESPACE::detail::process::posix {
 
@@ -39,22 +44,40 @@ inline bool is_code_running(int code)
 struct process_handle
 {
     int pid {-1};
+    // pidfd of the process if available, so we can't hit a reused pid.
+    int pidfd {-1};
     explicit process_handle(int pid) : pid(pid)
     {}
 
+    process_handle(int pid, int pidfd) : pid(pid), pidfd(pidfd)
+    {}
+
     process_handle()  = default;
-    ~process_handle() = default;
+    ~process_handle()
+    {
+        if (pidfd != -1)
+            ::close(pidfd);
+        if (pid != -1)
+            child_reaper::instance().forget(pid);
+    }
 
     process_handle(const process_handle & c) = delete;
-    process_handle(process_handle && c) : pid(c.pid)
+    process_handle(process_handle && c) : pid(c.pid), pidfd(c.pidfd)
     {
         c.pid = -1;
+        c.pidfd = -1;
     }
     process_handle &operator=(const process_handle & c) = delete;
     process_handle &operator=(process_handle && c)
     {
+        if (pidfd != -1)
+            ::close(pidfd);
+        if (pid != -1)
+            child_reaper::instance().forget(pid);
         pid = c.pid;
+        pidfd = c.pidfd;
         c.pid = -1;
+        c.pidfd = -1;
         return *this;
     }
 
@@ -75,7 +98,7 @@ struct process_handle
     {
         if (!is_code_running(exit_code))
             return false;
-        auto ret = ::waitpid(pid, &exit_code, WNOHANG);
+        auto ret = _wait(exit_code, WNOHANG);
 
         if (ret == -1)
             throw_last_error("waitpid() failed", pid);
@@ -85,75 +108,188 @@ struct process_handle
 
     void terminate_if_running()
     {
-        int exit_code;
-        if (!is_code_running(exit_code))
-            return;
-        auto ret = ::waitpid(pid, &exit_code, WNOHANG);
+        int exit_code = still_active;
+        _wait(exit_code, WNOHANG);
 
         if (is_code_running(exit_code))
-            ::kill(pid, SIGKILL);
+            _kill(SIGKILL);
     }
 
     void terminate() noexcept
     {
-        if (::kill(pid, SIGKILL) == -1)
+        if (_kill(SIGKILL) == -1)
             throw_last_error("terminate() failed", pid);
 
-        ::waitpid(pid, nullptr, WNOHANG); //just to clean it up
+        int exit_code = still_active;
+        _wait(exit_code, WNOHANG); //just to clean it up
     }
 
     void wait(int & exit_code)
     {
         pid_t ret;
-        int status;
+        int status = still_active;
 
         do
-            ret = ::waitpid(pid, &status, 0);
+            ret = _wait(status, 0);
         while (((ret == -1) && (errno == EINTR)) ||
-               (ret != -1 && !WIFEXITED(status) && !WIFSIGNALED(status)));
+               (ret != -1 && is_code_running(status)));
 
         if (ret == -1)
             throw_last_error("waitpid() failed", pid);
         exit_code = status;
     }
 
-    std::optional<asio::signal_set> sset;
+    // A pidfd becomes readable when the process exits, so we don't need SIGCHLD if we can get one.
+    std::optional<asio::posix::stream_descriptor> pidfd_stream;
 
     template<class Executor, class CompletionToken>
     auto async_wait(Executor& ctx, CompletionToken && token, std::atomic<int> & exit_code)
     {
-        sset.emplace(ctx, SIGCHLD);
-
         asio::async_completion<CompletionToken, void(int, std::error_code)> comp{token};
-        _check_status(std::move(comp.completion_handler), {}, exit_code);
 
+        // the stream_descriptor takes ownership, so we hand it a duplicate of our pidfd.
+        const int fd = pidfd != -1 ? ::fcntl(pidfd, F_DUPFD_CLOEXEC, 0) : pidfd_open(pid);
+        if (fd != -1)
+        {
+            pidfd_stream.emplace(ctx, fd);
+            _check_pidfd(std::move(comp.completion_handler), {}, exit_code);
+        }
+        else // no pidfd support, so we let the central reaper watch for SIGCHLD.
+        {
+            auto exec = _get_executor(ctx);
+            auto & service = use_sigchld_service(exec);
+            service.listen(exec);
+
+            _wait_published(exec, std::move(comp.completion_handler), exit_code, &service);
+            child_reaper::instance().reap(); // in case it exited before we listened
+        }
         return comp.result.get();
     }
 
-    void cancel_async_wait() { if (sset) sset->cancel(); }
+    void cancel_async_wait()
+    {
+        if (pidfd_stream)
+            pidfd_stream->cancel();
+        else
+            child_reaper::instance().cancel(pid);
+    }
 
 private:
+    template<typename Executor>
+    static auto _get_executor(Executor & ctx)
+    {
+        if constexpr (requires {ctx.get_executor();})
+            return ctx.get_executor();
+        else
+            return ctx;
+    }
+
+    // waitpid, but through the pidfd if we have one. Only updates exit_code if the process changed state.
+    // If the child got reaped by someone else (or isn't ours, e.g. launched by a fork_server),
+    // the status is taken from the child_reaper.
+    int _wait(int & exit_code, int options) const
+    {
+        auto & reaper = child_reaper::instance();
+        if (auto st = reaper.status(pid); st && !is_code_running(*st))
+        {
+            exit_code = *st;
+            return pid;
+        }
+
+        const auto ret = _wait_native(exit_code, options);
+        if (ret == pid)
+            reaper.publish(pid, exit_code);
+        else if (ret == -1 && errno == ECHILD)
+        {
+            auto st = (options & WNOHANG) ? reaper.status(pid) : reaper.wait(pid);
+            if (st && is_code_running(*st))
+                return 0;
+            else if (st)
+            {
+                exit_code = *st;
+                return pid;
+            }
+            errno = ECHILD;
+        }
+        return ret;
+    }
+
+    int _wait_native(int & exit_code, int options) const
+    {
+        if (pidfd == -1)
+            return ::waitpid(pid, &exit_code, options);
+
+        siginfo_t info{};
+        if (::waitid(p_pidfd, pidfd, &info, WEXITED | options) == -1)
+            return -1;
+        if (info.si_pid == 0) // WNOHANG & no change
+            return 0;
+        exit_code = status_from_siginfo(info);
+        return info.si_pid;
+    }
+
+    int _kill(int sig) const
+    {
+        if (pidfd == -1)
+            return ::kill(pid, sig);
+        return pidfd_send_signal(pidfd, sig);
+    }
+
+    // Let the child_reaper complete the handler once the status got published.
+    template<typename Executor, typename Handler>
+    void _wait_published(const Executor & exec, Handler && h, std::atomic<int> & exit_code, sigchld_service * service = nullptr)
+    {
+        auto handler = std::make_shared<std::decay_t<Handler>>(std::move(h));
+        // the reaper isn't known to asio, so we need to keep the context from running out of work.
+        auto work = std::make_shared<decltype(asio::make_work_guard(exec))>(asio::make_work_guard(exec));
+        child_reaper::instance().async_wait(pid,
+            [handler, work, service, &exit_code](std::error_code ec, int status)
+            {
+                if (service)
+                    service->done();
+                asio::post(work->get_executor(),
+                    [handler, work, ec, status, &exit_code]
+                    {
+                        if (!ec)
+                            exit_code = status;
+                        (*handler)(ec, ec ? 0 : eval_exit_status(status));
+                        work->reset();
+                    });
+            });
+    }
+
     template<typename Handler>
-    void _check_status(Handler && h, std::error_code ec, std::atomic<int> & exit_code)
+    void _check_pidfd(Handler && h, std::error_code ec, std::atomic<int> & exit_code, bool woken = false)
     {
         if (ec)
-            h(ec, 0);
+        {
+            pidfd_stream = std::nullopt;
+            return h(ec, 0);
+        }
         int status{exit_code.load()};
-        int ret = waitpid(pid, &status, WNOHANG);
+        int ret = _wait(status, WNOHANG);
 
         if (ret < 0)
         {
+            pidfd_stream = std::nullopt;
             h(get_last_error(), 0);
-            sset = std::nullopt;
         }
-        else if (ret == pid && !is_code_running(status))
+        else if (ret != 0 && !is_code_running(status))
         {
             exit_code = status;
+            pidfd_stream = std::nullopt;
             h({}, eval_exit_status(status));
-            sset = std::nullopt;
+        }
+        else if (woken)
+        {
+            // the process is gone, but not our child, so we wait for the status to be published.
+            auto exec = pidfd_stream->get_executor();
+            pidfd_stream = std::nullopt;
+            _wait_published(exec, std::move(h), exit_code);
         }
         else
-            sset->async_wait([this, &exit_code, h = std::move(h)](std::error_code ec, int) mutable { _check_status(std::move(h), ec, exit_code); });
+            pidfd_stream->async_wait(asio::posix::stream_descriptor::wait_read,
+                                     [this, &exit_code, h = std::move(h)](std::error_code ec) mutable { _check_pidfd(std::move(h), ec, exit_code, true); });
     }
 
 
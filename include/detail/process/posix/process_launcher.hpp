@@ -2,7 +2,17 @@
 #define DETAIL_PROCESS_POSIX_PROCESS_LAUNCHER_HPP
 
 #include <detail/process.hpp>
+#include <detail/process/posix/argv_buffer.hpp>
+#include <detail/process/posix/executable_handle.hpp>
+#include <detail/process/posix/search_path.hpp>
 #include <functional>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <asio/async_result.hpp>
+#include <asio/buffer.hpp>
+#include <asio/read.hpp>
 
 namespace PROCESS_NAMESPACE::detail::process::posix {
 
@@ -25,9 +35,12 @@ template<typename Init, typename Launcher = default_process_launcher>
 concept on_exec_error_init = requires(Init initializer, Launcher launcher) { {initializer.on_exec_error(launcher, std::error_code())}; };
 
 
-
+template<typename Handler, typename ... Inits>
+struct async_launch_op;
 
 class default_process_launcher {
+    template<typename Handler, typename ... Inits>
+    friend struct async_launch_op;
 protected:
     std::error_code _ec;
     const char * _error_msg = nullptr;
@@ -94,6 +107,15 @@ protected:
 
     std::string _msg_buffer;
 
+    // exec exe, or exe_fd if set.
+    void _exec(const std::filesystem::path & exe)
+    {
+        if (exe_fd != -1)
+            exec_fd(exe_fd, cmd_line, env);
+        else
+            ::execve(exe.c_str(), cmd_line, env);
+    }
+
     void _read_error(int source)
     {
         int data[2];
@@ -134,21 +156,198 @@ public:
         _error_msg = msg;
     }
 
+    // Copies exe & args into a single null terminated block, which doesn't allocate for typical commands.
     template<typename Args>
     auto prepare_args(const std::filesystem::path &exe, Args && args)
     {
-        std::vector<char*> vec{args.size() + 2, nullptr};
-        vec[0] = const_cast<char*>(exe.c_str());
-        std::transform(std::begin(args), std::end(args), vec.begin() + 1, [](std::string_view sv){return const_cast<char*>(sv.data());});
-        return vec;
+        return argv_buffer{exe.native(), std::forward<Args>(args)};
     }
 
     template<typename Args, typename ... Inits>
     auto launch(const std::filesystem::path &exe, Args && args, Inits && ... inits) -> PROCESS_NAMESPACE::process
     {
-        //arg store
+        return _launch([]{return ::fork();}, exe, std::forward<Args>(args), std::forward<Inits>(inits)...);
+    }
+
+    // Launch a pre-opened executable, argv[0] is its path.
+    template<typename Args, typename ... Inits>
+    auto launch(const executable_handle &exe, Args && args, Inits && ... inits) -> PROCESS_NAMESPACE::process
+    {
+        exe_fd = exe.native_handle();
+        return launch(exe.path(), std::forward<Args>(args), std::forward<Inits>(inits)...);
+    }
+
+    // Launch with an argv prepared beforehand, i.e. a null terminated array starting with the exe.
+    template<typename ... Inits>
+    auto launch_prepared(const std::filesystem::path &exe, char * const * argv, Inits && ... inits) -> PROCESS_NAMESPACE::process
+    {
+        return _launch_prepared([]{return ::fork();}, resolve_executable(exe), argv, std::forward<Inits>(inits)...);
+    }
+
+    // Launch count processes with the same arguments & initializers. The shared setup is done once,
+    // and the exec errors of all children are collected with a single poll.
+    // If any of them fails to launch, all others get terminated and the first error is thrown.
+    template<typename Args, typename ... Inits>
+    auto launch_many(const std::filesystem::path &exe, Args && args, std::size_t count, Inits && ... inits)
+        -> std::vector<PROCESS_NAMESPACE::process>
+    {
+        const auto path = exe_fd != -1 ? exe : resolve_executable(exe);
         auto arg_store = prepare_args(exe, std::forward<Args>(args));
         cmd_line = arg_store.data();
+
+        (_on_setup(inits),...);
+        if (_ec)
+        {
+            (_on_error(inits),...);
+            throw process_error(_ec, _error_msg, exe);
+        }
+
+        std::vector<PROCESS_NAMESPACE::process> procs;
+        std::vector<pollfd> pipes;
+        procs.reserve(count);
+        pipes.reserve(count);
+
+        for (std::size_t i = 0u; i < count; i++)
+        {
+            int p[2];
+            // both ends are CLOEXEC, so the siblings don't inherit them.
+            if (::pipe2(p, O_CLOEXEC) == -1)
+            {
+                set_error(get_last_error(), "pipe(2) failed");
+                break;
+            }
+
+            pid = ::fork();
+            if (pid == -1)
+            {
+                set_error(get_last_error(), "fork() failed");
+                ::close(p[0]);
+                ::close(p[1]);
+                (_on_fork_error(inits),...);
+                break;
+            }
+            else if (pid == 0)
+            {
+                (_on_exec_setup(inits),...);
+
+                _exec(path);
+                set_error(get_last_error(), "execve failed");
+
+                _write_error(p[1], _error_msg);
+                _exit(EXIT_FAILURE);
+            }
+            ::close(p[1]);
+            pipes.push_back(pollfd{p[0], POLLIN, 0});
+            procs.emplace_back(pid);
+        }
+
+        // _read_error overwrites the error, so we keep the first one here.
+        std::error_code first_ec = _ec;
+        std::string first_msg = _ec ? _error_msg : "";
+
+        for (std::size_t open = pipes.size(); open > 0u;)
+        {
+            if (::poll(pipes.data(), pipes.size(), -1) == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+                if (!first_ec)
+                {
+                    first_ec = get_last_error();
+                    first_msg = "poll(2) failed";
+                }
+                break;
+            }
+
+            for (auto & p : pipes)
+                if (p.fd != -1 && p.revents != 0)
+                {
+                    _read_error(p.fd);
+                    if (_ec && !first_ec)
+                    {
+                        first_ec = _ec;
+                        first_msg = _error_msg;
+                    }
+                    ::close(p.fd);
+                    p.fd = -1;
+                    open--;
+                }
+        }
+        for (auto & p : pipes)
+            if (p.fd != -1)
+                ::close(p.fd);
+
+        if (first_ec)
+        {
+            for (auto & proc : procs)
+            {
+                ::kill(proc.id(), SIGKILL); // not reaped yet, so the pid is still ours.
+                proc.wait();
+            }
+            _msg_buffer = std::move(first_msg);
+            set_error(first_ec, _msg_buffer.c_str());
+            (_on_error(inits),...);
+            throw process_error(_ec, _error_msg, exe);
+        }
+
+        for (auto & proc : procs)
+        {
+            pid = proc.id();
+            (_on_success(inits),...);
+        }
+
+        if (_ec)
+        {
+            (_on_error(inits),...);
+            throw process_error(_ec, _error_msg, exe);
+        }
+        return procs;
+    }
+
+    template<typename Args, typename ... Inits>
+    auto launch_many(const executable_handle &exe, Args && args, std::size_t count, Inits && ... inits)
+        -> std::vector<PROCESS_NAMESPACE::process>
+    {
+        exe_fd = exe.native_handle();
+        return launch_many(exe.path(), std::forward<Args>(args), count, std::forward<Inits>(inits)...);
+    }
+
+    // Launch without blocking on the result of exec: the error pipe gets read asynchronously.
+    // The completion signature is void(std::error_code, process), the initializers get moved into the operation.
+    template<typename Executor, typename Args, typename CompletionToken, typename ... Inits>
+    auto async_launch(Executor && exec, const std::filesystem::path &exe, Args && args, CompletionToken && token, Inits && ... inits)
+    {
+        asio::async_completion<CompletionToken, void(std::error_code, PROCESS_NAMESPACE::process)> comp{token};
+        using op_t = async_launch_op<std::decay_t<decltype(comp.completion_handler)>, std::decay_t<Inits>...>;
+
+        auto op = std::make_shared<op_t>(std::move(*this), exec, exe, std::move(comp.completion_handler), std::forward<Inits>(inits)...);
+        op->start(std::forward<Args>(args));
+        return comp.result.get();
+    }
+
+    const char * exe      = nullptr;
+    char *const* cmd_line = nullptr;
+    char **env      = ::environ;
+    pid_t pid = -1;
+    int pidfd = -1;
+    int exe_fd = -1; // if set, this file gets executed instead of the path
+
+protected:
+    // Fork is a callable that creates the child, i.e. returns the pid & optionally sets pidfd.
+    // A bare exe name gets looked up in PATH, argv[0] keeps the name as given.
+    template<typename Fork, typename Args, typename ... Inits>
+    auto _launch(Fork && fork, const std::filesystem::path &exe, Args && args, Inits && ... inits) -> PROCESS_NAMESPACE::process
+    {
+        //arg store
+        auto arg_store = prepare_args(exe, std::forward<Args>(args));
+        return _launch_prepared(std::forward<Fork>(fork), exe_fd != -1 ? exe : resolve_executable(exe),
+                                arg_store.data(), std::forward<Inits>(inits)...);
+    }
+
+    template<typename Fork, typename ... Inits>
+    auto _launch_prepared(Fork && fork, const std::filesystem::path &exe, char * const * argv, Inits && ... inits) -> PROCESS_NAMESPACE::process
+    {
+        cmd_line = argv;
         struct pipe_guard
         {
             int p[2];
@@ -179,7 +378,7 @@ public:
                 throw process_error(_ec, _error_msg, exe);
             }
 
-            pid = ::fork();
+            pid = fork();
             if (pid == -1)
             {
                 set_error(get_last_error(), "fork() failed");
@@ -192,7 +391,7 @@ public:
                 ::close(p.p[0]);
                 (_on_exec_setup(inits),...);
 
-                ::execve(exe.c_str(), cmd_line, env);
+                _exec(exe);
                 set_error(get_last_error(), "execve failed");
 
                 _write_error(p.p[1], _error_msg);
@@ -207,12 +406,15 @@ public:
             _read_error(p.p[0]);
 
         }
+        process_handle handle{pid, std::exchange(pidfd, -1)};
         if (_ec)
         {
+            int exit_code;
+            handle.wait(exit_code); // reap the failed child, so it doesn't linger as a zombie
             (_on_error(inits),...);
             throw process_error(_ec, _error_msg, exe);
         }
-        PROCESS_NAMESPACE::process proc{pid};
+        PROCESS_NAMESPACE::process proc{std::move(handle)};
         (_on_success(inits),...);
 
         if (_ec)
@@ -223,11 +425,127 @@ public:
 
         return proc;
     }
+};
 
-    const char * exe      = nullptr;
-    char *const* cmd_line = nullptr;
-    char **env      = ::environ;
-    pid_t pid = -1;
+template<typename Handler, typename ... Inits>
+struct async_launch_op : std::enable_shared_from_this<async_launch_op<Handler, Inits...>>
+{
+    default_process_launcher launcher;
+    std::filesystem::path exe;
+    Handler handler;
+    std::tuple<Inits...> inits;
+    asio::posix::stream_descriptor pipe;
+    int header[2] = {0, 0};
+    std::string msg;
+
+    template<typename Exec, typename ... Inits_>
+    async_launch_op(default_process_launcher && launcher, Exec && exec, const std::filesystem::path & exe, Handler && handler, Inits_ && ... inits)
+        : launcher(std::move(launcher)), exe(exe), handler(std::move(handler)), inits(std::forward<Inits_>(inits)...), pipe(exec)
+    {
+    }
+
+    template<typename Args>
+    void start(Args && args)
+    {
+        auto & l = launcher;
+        auto arg_store = l.prepare_args(exe, std::forward<Args>(args));
+        l.cmd_line = arg_store.data();
+        const auto path = l.exe_fd != -1 ? exe : resolve_executable(exe);
+
+        int p[2];
+        if (::pipe2(p, O_CLOEXEC) == -1)
+            return _post_error(get_last_error(), "pipe(2) failed");
+
+        std::apply([&](auto & ... in){(l._on_setup(in),...);}, inits);
+        if (l._ec)
+        {
+            ::close(p[0]);
+            ::close(p[1]);
+            return _post_error(l._ec, l._error_msg);
+        }
+
+        l.pid = ::fork();
+        if (l.pid == -1)
+        {
+            ::close(p[0]);
+            ::close(p[1]);
+            l.set_error(get_last_error(), "fork() failed");
+            std::apply([&](auto & ... in){(l._on_fork_error(in),...);}, inits);
+            return _post_error(l._ec, l._error_msg);
+        }
+        else if (l.pid == 0)
+        {
+            ::close(p[0]);
+            std::apply([&](auto & ... in){(l._on_exec_setup(in),...);}, inits);
+
+            l._exec(path);
+            l.set_error(get_last_error(), "execve failed");
+
+            l._write_error(p[1], l._error_msg);
+            _exit(EXIT_FAILURE);
+        }
+        ::close(p[1]);
+        pipe.assign(p[0]);
+
+        // EOF means exec succeeded, otherwise the child sends the error code & message.
+        asio::async_read(pipe, asio::buffer(header),
+                [self = this->shared_from_this()](std::error_code ec, std::size_t n)
+                {
+                    self->_on_header(ec, n);
+                });
+    }
+
+private:
+    void _post_error(std::error_code ec, const char * msg)
+    {
+        launcher.set_error(ec, msg);
+        std::apply([&](auto & ... in){(launcher._on_error(in),...);}, inits);
+        asio::post(pipe.get_executor(),
+                   [self = this->shared_from_this()]
+                   {
+                       std::move(self->handler)(self->launcher._ec, PROCESS_NAMESPACE::process{});
+                   });
+    }
+
+    void _on_header(std::error_code ec, std::size_t n)
+    {
+        process_handle handle{launcher.pid, std::exchange(launcher.pidfd, -1)};
+        if (n == 0u && ec == std::error_code(asio::error::make_error_code(asio::error::eof)))
+        {
+            PROCESS_NAMESPACE::process proc{std::move(handle)};
+            std::apply([&](auto & ... in){(launcher._on_success(in),...);}, inits);
+            if (launcher._ec)
+                return _fail();
+            std::move(handler)(std::error_code{}, std::move(proc));
+        }
+        else if (ec)
+        {
+            // we don't know if exec succeeded, so the child is of no use.
+            int exit_code;
+            handle.terminate();
+            handle.wait(exit_code);
+            launcher.set_error(ec, "Error read pipe");
+            _fail();
+        }
+        else
+        {
+            msg.resize(static_cast<std::size_t>(header[1]));
+            asio::async_read(pipe, asio::buffer(msg),
+                    [self = this->shared_from_this(), handle = std::move(handle)](std::error_code, std::size_t) mutable
+                    {
+                        int exit_code;
+                        handle.wait(exit_code); // the child exits right after writing the error
+                        self->launcher.set_error(std::error_code(self->header[0], std::system_category()), self->msg.c_str());
+                        self->_fail();
+                    });
+        }
+    }
+
+    void _fail()
+    {
+        std::apply([&](auto & ... in){(launcher._on_error(in),...);}, inits);
+        std::move(handler)(launcher._ec, PROCESS_NAMESPACE::process{});
+    }
 };
 
 }
@@ -0,0 +1,190 @@
+#ifndef DETAIL_PROCESS_POSIX_SEARCH_PATH_HPP
+#define DETAIL_PROCESS_POSIX_SEARCH_PATH_HPP
+
+#include <detail/process/config.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+namespace PROCESS_NAMESPACE::detail::process::posix {
+
+// Process wide cache of executable lookups in PATH. Misses are cached too.
+// The PATH directories are watched with inotify, so a hit costs a hash lookup & a non-blocking read.
+// Directories that can't be watched (or all, without inotify) get their mtime compared instead.
+// Any change in a directory or in the PATH variable itself flushes the whole cache.
+class path_cache
+{
+public:
+    static path_cache & instance()
+    {
+        static path_cache cache;
+        return cache;
+    }
+
+    // Find name in PATH, returns an empty path if it can't be found.
+    std::filesystem::path find(std::string_view name)
+    {
+        std::lock_guard lock{_mutex};
+        _check_path();
+        _check_dirs();
+
+        auto itr = _entries.find(std::string(name));
+        if (itr != _entries.end())
+            return itr->second;
+
+        auto res = _lookup(name);
+        if (_cacheable)
+            _entries.emplace(name, res);
+        return res;
+    }
+
+    // Drop all cached entries, e.g. after installing a program in a way that isn't noticed.
+    void flush()
+    {
+        std::lock_guard lock{_mutex};
+        _entries.clear();
+    }
+
+    path_cache(const path_cache & ) = delete;
+    path_cache& operator=(const path_cache & ) = delete;
+
+    ~path_cache()
+    {
+        if (_notify != -1)
+            ::close(_notify);
+    }
+
+private:
+    path_cache() = default;
+
+    struct directory
+    {
+        std::filesystem::path path;
+        int wd = -1;
+        struct timespec mtime{};
+    };
+
+    std::mutex _mutex;
+    std::string _path_var;
+    bool _initialized = false;
+    bool _cacheable = true; // results depend on the working directory if PATH has relative entries
+    int _notify = -1;
+    std::vector<directory> _dirs;
+    std::unordered_map<std::string, std::filesystem::path> _entries;
+
+    static struct timespec _mtime(const std::filesystem::path & dir)
+    {
+        struct stat st;
+        if (::stat(dir.c_str(), &st) == -1)
+            return {};
+        return st.st_mtim;
+    }
+
+    // Rebuild the directory list if PATH changed.
+    void _check_path()
+    {
+        // execvp uses the same default if PATH is unset
+        const char * var = ::getenv("PATH");
+        const std::string_view path_var = var ? var : "/bin:/usr/bin";
+        if (_initialized && path_var == _path_var)
+            return;
+
+        _initialized = true;
+        _path_var = path_var;
+        _entries.clear();
+        _dirs.clear();
+        _cacheable = true;
+        if (_notify != -1)
+            ::close(_notify);
+#if defined(__linux__)
+        _notify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+
+        std::string_view rest = _path_var;
+        for (;;)
+        {
+            const auto sep = rest.find(env_sep<char>);
+            const auto dir = rest.substr(0, sep);
+
+            // an empty entry denotes the current directory
+            directory d{dir.empty() ? "." : std::filesystem::path(dir)};
+            d.mtime = _mtime(d.path);
+            if (d.path.is_relative())
+                _cacheable = false;
+#if defined(__linux__)
+            if (_notify != -1)
+                d.wd = ::inotify_add_watch(_notify, d.path.c_str(),
+                                           IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB |
+                                           IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+#endif
+            _dirs.push_back(std::move(d));
+
+            if (sep == std::string_view::npos)
+                break;
+            rest = rest.substr(sep + 1);
+        }
+    }
+
+    // Flush the cache if any of the directories changed.
+    void _check_dirs()
+    {
+        bool changed = false;
+#if defined(__linux__)
+        if (_notify != -1)
+        {
+            alignas(struct inotify_event) char buf[4096];
+            while (::read(_notify, buf, sizeof(buf)) > 0)
+                changed = true;
+        }
+#endif
+        for (auto & d : _dirs)
+            if (d.wd == -1)
+            {
+                const auto mtime = _mtime(d.path);
+                if (mtime.tv_sec != d.mtime.tv_sec || mtime.tv_nsec != d.mtime.tv_nsec)
+                {
+                    d.mtime = mtime;
+                    changed = true;
+                }
+            }
+
+        if (changed)
+            _entries.clear();
+    }
+
+    std::filesystem::path _lookup(std::string_view name) const
+    {
+        for (const auto & d : _dirs)
+        {
+            auto candidate = d.path / name;
+            struct stat st;
+            if (::stat(candidate.c_str(), &st) == 0 && S_ISREG(st.st_mode) && ::access(candidate.c_str(), X_OK) == 0)
+                return candidate;
+        }
+        return {};
+    }
+};
+
+// Resolve exe through the path_cache if it's a bare name, otherwise or if not found, exe is returned unchanged.
+inline std::filesystem::path resolve_executable(const std::filesystem::path & exe)
+{
+    if (exe.empty() || exe.has_parent_path())
+        return exe;
+    auto res = path_cache::instance().find(exe.native());
+    return res.empty() ? exe : res;
+}
+
+}
+
+#endif //DETAIL_PROCESS_POSIX_SEARCH_PATH_HPP
@@ -0,0 +1,133 @@
+#ifndef DETAIL_PROCESS_POSIX_SPAWN_LAUNCHER_HPP
+#define DETAIL_PROCESS_POSIX_SPAWN_LAUNCHER_HPP
+
+#include <detail/process/posix/process_launcher.hpp>
+#include <spawn.h>
+
+namespace PROCESS_NAMESPACE::detail::process::posix {
+
+class spawn_process_launcher;
+
+template<typename Init, typename Launcher = spawn_process_launcher>
+concept on_spawn_setup_init = requires(Init initializer, Launcher launcher) { {initializer.on_spawn_setup(launcher)}; };
+
+// An initializer can be handled by posix_spawn if it does not need to run code in the child,
+// or if it can express that code as spawn file actions & attributes.
+template<typename Init, typename Launcher = spawn_process_launcher>
+concept spawnable_init = !on_exec_setup_init<Init, Launcher> || on_spawn_setup_init<Init, Launcher>;
+
+// Launcher based on posix_spawn, which avoids copying the page tables of the parent (vfork semantics on glibc).
+// If any initializer needs to run arbitrary code in the child (i.e. only provides on_exec_setup),
+// it falls back to the fork based default_process_launcher.
+class spawn_process_launcher : public default_process_launcher
+{
+    posix_spawn_file_actions_t _file_actions;
+    posix_spawnattr_t _attr;
+    short _flags = 0;
+
+    template<typename Initializer>
+    void _on_spawn_setup(Initializer &&initializer) {}
+
+    template<typename Initializer> requires on_spawn_setup_init<Initializer>
+    void _on_spawn_setup(Initializer &&init) { init.on_spawn_setup(*this); }
+
+    void _check(int err, const char * msg)
+    {
+        if (err != 0 && !_ec)
+            set_error(std::error_code(err, std::system_category()), msg);
+    }
+public:
+    spawn_process_launcher()
+    {
+        ::posix_spawn_file_actions_init(&_file_actions);
+        ::posix_spawnattr_init(&_attr);
+    }
+    ~spawn_process_launcher()
+    {
+        ::posix_spawn_file_actions_destroy(&_file_actions);
+        ::posix_spawnattr_destroy(&_attr);
+    }
+
+    spawn_process_launcher(const spawn_process_launcher & ) = delete;
+    spawn_process_launcher& operator=(const spawn_process_launcher & ) = delete;
+
+    // Duplicate fd onto new_fd in the child, i.e. dup2(fd, new_fd).
+    void add_dup2(int fd, int new_fd)
+    {
+        _check(::posix_spawn_file_actions_adddup2(&_file_actions, fd, new_fd), "posix_spawn_file_actions_adddup2 failed");
+    }
+
+    // Close fd in the child.
+    void add_close(int fd)
+    {
+        _check(::posix_spawn_file_actions_addclose(&_file_actions, fd), "posix_spawn_file_actions_addclose failed");
+    }
+
+    // Change the working directory of the child.
+    void add_chdir(const std::filesystem::path & dir)
+    {
+        _check(::posix_spawn_file_actions_addchdir_np(&_file_actions, dir.c_str()), "posix_spawn_file_actions_addchdir_np failed");
+    }
+
+    // Put the child into the process group pgid, 0 creates a new group.
+    void set_pgroup(pid_t pgid)
+    {
+        _flags |= POSIX_SPAWN_SETPGROUP;
+        _check(::posix_spawnattr_setpgroup(&_attr, pgid), "posix_spawnattr_setpgroup failed");
+    }
+
+    // posix_spawn can't execute a file descriptor, so this always uses fork.
+    template<typename Args, typename ... Inits>
+    auto launch(const executable_handle &exe, Args && args, Inits && ... inits) -> PROCESS_NAMESPACE::process
+    {
+        return default_process_launcher::launch(exe, std::forward<Args>(args), std::forward<Inits>(inits)...);
+    }
+
+    template<typename Args, typename ... Inits>
+    auto launch(const std::filesystem::path &exe, Args && args, Inits && ... inits) -> PROCESS_NAMESPACE::process
+    {
+        if constexpr (!(spawnable_init<Inits> && ...))
+            return default_process_launcher::launch(exe, std::forward<Args>(args), std::forward<Inits>(inits)...);
+        else
+        {
+            auto arg_store = prepare_args(exe, std::forward<Args>(args));
+            cmd_line = arg_store.data();
+
+            (_on_setup(inits),...);
+            (_on_spawn_setup(inits),...);
+
+            if (!_ec)
+                _check(::posix_spawnattr_setflags(&_attr, _flags), "posix_spawnattr_setflags failed");
+
+            if (_ec)
+            {
+                (_on_error(inits),...);
+                throw process_error(_ec, _error_msg, exe);
+            }
+
+            // glibc reports the execve error through the return value, so we don't need an error pipe.
+            const auto path = resolve_executable(exe);
+            _check(::posix_spawn(&pid, path.c_str(), &_file_actions, &_attr, cmd_line, env), "posix_spawn failed");
+            if (_ec)
+            {
+                (_on_error(inits),...);
+                throw process_error(_ec, _error_msg, exe);
+            }
+
+            PROCESS_NAMESPACE::process proc{pid};
+            (_on_success(inits),...);
+
+            if (_ec)
+            {
+                (_on_error(inits),...);
+                throw process_error(_ec, _error_msg, exe);
+            }
+
+            return proc;
+        }
+    }
+};
+
+}
+
+#endif //DETAIL_PROCESS_POSIX_SPAWN_LAUNCHER_HPP
@@ -241,6 +241,20 @@ struct process_io
             e.set_error(detail::process::get_last_error(), "dup2(stderr) failed");
 
     }
+    template <typename Launcher>
+    void on_spawn_setup(Launcher &e) const
+    {
+        auto & [h_in_, h_out_, h_err_] = _get_handles();
+        if (auto h_in = static_cast<int>(h_in_); h_in != STDIN_FILENO)
+            e.add_dup2(h_in, STDIN_FILENO);
+
+        if (auto h_out = static_cast<int>(h_out_); h_out != STDOUT_FILENO)
+            e.add_dup2(h_out, STDOUT_FILENO);
+
+        if (auto h_err = static_cast<int>(h_err_); h_err != STDERR_FILENO)
+            e.add_dup2(h_err, STDERR_FILENO);
+    }
+
     template <typename Launcher>
     void on_setup(const Launcher &e) {}
 #else
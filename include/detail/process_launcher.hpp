@@ -3,6 +3,9 @@
 
 #if defined(__unix__)
 #include <detail/process/posix/process_launcher.hpp>
+#include <detail/process/posix/spawn_launcher.hpp>
+#include <detail/process/posix/clone3_launcher.hpp>
+#include <detail/process/posix/fork_server.hpp>
 #endif
 #if defined(_WIN32) || defined(WIN32)
 #include <detail/process/windows/process_launcher.hpp>
@@ -16,10 +19,102 @@ class default_process_launcher : detail::process::api::default_process_launcher
 public:
     using detail::process::api::default_process_launcher::set_error;
     using detail::process::api::default_process_launcher::launch;
+#if defined(__unix__)
+    using detail::process::api::default_process_launcher::launch_many;
+    using detail::process::api::default_process_launcher::async_launch;
+#endif
 };
 
 static_assert(process_launcher<default_process_launcher>);
 
+#if defined(__unix__)
+// Launch count identical processes, doing the shared preparation only once.
+template<typename Args, detail::process_initializer<default_process_launcher> ... Inits>
+std::vector<process> launch_many(const std::filesystem::path& exe, Args&& args, std::size_t count, Inits&&... inits)
+{
+    return default_process_launcher{}.launch_many(exe, std::forward<Args>(args), count, std::forward<Inits>(inits)...);
+}
+
+template<detail::process_initializer<default_process_launcher> ... Inits>
+std::vector<process> launch_many(const std::filesystem::path& exe, std::initializer_list<std::string_view> args, std::size_t count, Inits&&... inits)
+{
+    return default_process_launcher{}.launch_many(exe, args, count, std::forward<Inits>(inits)...);
+}
+#endif
+
+#if defined(__unix__)
+namespace detail
+{
+
+template<typename Executor, typename Args, typename Tuple, std::size_t ... Idx>
+auto async_launch_impl(Executor && exec, const std::filesystem::path& exe, Args&& args, Tuple && inits_and_token, std::index_sequence<Idx...>)
+{
+    return default_process_launcher{}.async_launch(std::forward<Executor>(exec), exe, std::forward<Args>(args),
+                                                   std::get<sizeof...(Idx)>(std::move(inits_and_token)),
+                                                   std::get<Idx>(std::move(inits_and_token))...);
+}
+
+}
+
+// Launch a process without blocking the caller until it exec'd. The last argument is the completion token,
+// with the signature void(std::error_code, process).
+template<typename Executor, typename Args, typename ... InitsAndToken>
+    requires (sizeof...(InitsAndToken) > 0u)
+auto async_launch(Executor && exec, const std::filesystem::path& exe, Args&& args, InitsAndToken&&... inits_and_token)
+{
+    return detail::async_launch_impl(std::forward<Executor>(exec), exe, std::forward<Args>(args),
+                                     std::forward_as_tuple(std::forward<InitsAndToken>(inits_and_token)...),
+                                     std::make_index_sequence<sizeof...(InitsAndToken) - 1u>{});
+}
+
+template<typename Executor, typename ... InitsAndToken>
+    requires (sizeof...(InitsAndToken) > 0u)
+auto async_launch(Executor && exec, const std::filesystem::path& exe, std::initializer_list<std::string_view> args, InitsAndToken&&... inits_and_token)
+{
+    return detail::async_launch_impl(std::forward<Executor>(exec), exe, args,
+                                     std::forward_as_tuple(std::forward<InitsAndToken>(inits_and_token)...),
+                                     std::make_index_sequence<sizeof...(InitsAndToken) - 1u>{});
+}
+#endif
+
+#if defined(__unix__)
+// Launcher using posix_spawn, falls back to fork if an initializer requires to run code in the child.
+class spawn_process_launcher : detail::process::posix::spawn_process_launcher
+{
+public:
+    using detail::process::posix::spawn_process_launcher::set_error;
+    using detail::process::posix::spawn_process_launcher::launch;
+};
+
+static_assert(process_launcher<spawn_process_launcher>);
+
+// Launcher using clone3, so the process holds a pidfd, which avoids pid reuse races.
+class clone3_process_launcher : detail::process::posix::clone3_process_launcher
+{
+public:
+    using detail::process::posix::clone3_process_launcher::clone3_process_launcher;
+    using detail::process::posix::clone3_process_launcher::set_error;
+    using detail::process::posix::clone3_process_launcher::launch;
+};
+
+static_assert(process_launcher<clone3_process_launcher>);
+
+// An executable opened once, that launchers can execute without resolving its path again.
+using executable_handle = detail::process::posix::executable_handle;
+
+// Helper process that launches processes on our behalf, create it early on.
+using fork_server = detail::process::posix::fork_server;
+
+// Launcher using a fork_server, falls back to fork if an initializer requires to run code in the child.
+class fork_server_launcher : detail::process::posix::fork_server_launcher
+{
+public:
+    using detail::process::posix::fork_server_launcher::fork_server_launcher;
+    using detail::process::posix::fork_server_launcher::set_error;
+    using detail::process::posix::fork_server_launcher::launch;
+};
+#endif
+
 }
 
 #endif //PROCESS_HPP
@@ -22,6 +22,12 @@ struct process_start_dir
         ::chdir(s_.c_str());
     }
 
+    template <class SpawnLauncher>
+    void on_spawn_setup(SpawnLauncher& exec) const
+    {
+        exec.add_chdir(s_);
+    }
+
     template <class Executor>
     void on_setup(Executor& exec) const
     {
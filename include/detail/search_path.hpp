@@ -0,0 +1,28 @@
+#ifndef PROCESS_SEARCH_PATH_HPP
+#define PROCESS_SEARCH_PATH_HPP
+
+#include <detail/process/config.hpp>
+#include <filesystem>
+#include <string_view>
+
+#if defined(__unix__)
+#include <detail/process/posix/search_path.hpp>
+#endif
+
+namespace PROCESS_NAMESPACE
+{
+
+#if defined(__unix__)
+
+// Find an executable in PATH, returns an empty path if it can't be found.
+// Results are cached process wide and invalidated when PATH or any of its directories change.
+inline std::filesystem::path search_path(std::string_view name)
+{
+    return detail::process::posix::path_cache::instance().find(name);
+}
+
+#endif
+
+}
+
+#endif //PROCESS_SEARCH_PATH_HPP
@@ -4,4 +4,6 @@
 #include <detail/process_io.hpp>
 #include <detail/process_env.hpp>
 #include <detail/process_limit_handles.hpp>
-#include <detail/process_start_dir.hpp>
\ No newline at end of file
+#include <detail/process_start_dir.hpp>
+#include <detail/search_path.hpp>
+#include <detail/command_template.hpp>
\ No newline at end of file
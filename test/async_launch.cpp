@@ -0,0 +1,94 @@
+#include "doctest.hpp"
+
+#include <filesystem>
+#include <process.hpp>
+
+#include <fstream>
+#include <optional>
+
+extern std::filesystem::path target_path;
+
+#if defined(__unix__)
+
+struct deleter
+{
+    const std::filesystem::path & pt;
+    deleter(const std::filesystem::path & pt) : pt(pt) {}
+    ~deleter()
+    {
+        std::filesystem::remove(pt);
+    }
+};
+
+TEST_CASE("async_launch")
+{
+    asio::io_context ioc;
+    std::optional<proc::process> launched;
+    std::error_code launch_ec;
+    bool did_something_else = false;
+
+    proc::async_launch(ioc, target_path, {"--exit-code", "42"},
+                       [&](std::error_code ec, proc::process p)
+                       {
+                           launch_ec = ec;
+                           launched.emplace(std::move(p));
+                       });
+    asio::post(ioc, [&]{did_something_else = true;});
+    ioc.run();
+
+    CHECK(!launch_ec);
+    REQUIRE(launched);
+    CHECK(launched->valid());
+    launched->wait();
+    CHECK(launched->exit_code() == 42);
+    CHECK(did_something_else);
+}
+
+TEST_CASE("async_launch_error")
+{
+    asio::io_context ioc;
+    std::error_code launch_ec;
+    bool done = false;
+
+    proc::async_launch(ioc, target_path / "does-not-exist", {"--exit-code", "42"},
+                       [&](std::error_code ec, proc::process p)
+                       {
+                           launch_ec = ec;
+                           done = true;
+                           CHECK(!p.valid());
+                       });
+    ioc.run();
+
+    CHECK(done);
+    CHECK(launch_ec == std::errc::no_such_file_or_directory);
+}
+
+TEST_CASE("async_launch_initializers")
+{
+    const auto tmp = std::filesystem::temp_directory_path() / "std_process_tmp_file";
+    deleter d{tmp};
+
+    asio::io_context ioc;
+    std::optional<proc::process> launched;
+
+    std::vector<std::string> args{"--env", "FOO"};
+    proc::async_launch(ioc.get_executor(), target_path, args,
+                       proc::process_env{{"FOO", "ASYNC"}}, proc::process_io{{}, tmp},
+                       [&](std::error_code ec, proc::process p)
+                       {
+                           CHECK(!ec);
+                           launched.emplace(std::move(p));
+                       });
+    ioc.run();
+
+    REQUIRE(launched);
+    launched->wait();
+    CHECK(launched->exit_code() == 0);
+
+    std::ifstream ifs{tmp};
+    std::string line;
+    CHECK(std::getline(ifs, line));
+    CHECK(line == "ASYNC");
+}
+
+#endif
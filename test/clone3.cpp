@@ -0,0 +1,44 @@
+#include "doctest.hpp"
+
+#include <filesystem>
+#include <process.hpp>
+
+#include <iostream>
+
+extern std::filesystem::path target_path;
+
+TEST_CASE("clone3_exit_code")
+{
+    std::vector<std::string_view> args = {"--exit-code", "42"};
+    auto proc1 = proc::clone3_process_launcher{}.launch(target_path, args);
+    CHECK(proc1._process_handle.pidfd != -1);
+    proc1.wait();
+    CHECK(!proc1.running());
+    CHECK(proc1.exit_code() == 42);
+}
+
+TEST_CASE("clone3_vfork")
+{
+    std::vector<std::string_view> args = {"--exit-code", "43", "--wait", "50"};
+    auto proc1 = proc::clone3_process_launcher{true}.launch(target_path, args);
+    CHECK(proc1.running());
+    proc1.wait();
+    CHECK(proc1.exit_code() == 43);
+}
+
+TEST_CASE("clone3_terminate")
+{
+    std::vector<std::string_view> args = {"--wait", "10000"};
+    auto proc1 = proc::clone3_process_launcher{}.launch(target_path, args);
+    CHECK(proc1.running());
+    proc1.terminate();
+    proc1.wait();
+    CHECK(!proc1.running());
+    CHECK(proc1.exit_code() == SIGKILL);
+}
+
+TEST_CASE("clone3_error")
+{
+    std::vector<std::string_view> args;
+    CHECK_THROWS_AS(proc::clone3_process_launcher{}.launch(target_path / "does-not-exist", args), proc::process_error);
+}
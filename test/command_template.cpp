@@ -0,0 +1,58 @@
+#include "doctest.hpp"
+
+#include <filesystem>
+#include <process.hpp>
+
+#include <iostream>
+#include <fstream>
+
+extern std::filesystem::path target_path;
+
+#if defined(__unix__)
+
+struct deleter
+{
+    const std::filesystem::path & pt;
+    deleter(const std::filesystem::path & pt) : pt(pt) {}
+    ~deleter()
+    {
+        std::filesystem::remove(pt);
+    }
+};
+
+TEST_CASE("command_template")
+{
+    proc::command_template cmd{target_path, {"--wait", "10"}};
+    CHECK(cmd.exe().is_absolute());
+
+    for (int i = 0; i < 4; i++)
+    {
+        auto p = cmd.launch();
+        p.wait();
+        CHECK(p.exit_code() == 0);
+    }
+
+    auto p = cmd.launch({"--exit-code", "43"});
+    p.wait();
+    CHECK(p.exit_code() == 43);
+
+    CHECK_THROWS_AS(proc::command_template(target_path / "does-not-exist", {"--exit-code", "42"}), proc::process_error);
+}
+
+TEST_CASE("command_template_env")
+{
+    const auto tmp = std::filesystem::temp_directory_path() / "std_process_tmp_file";
+    deleter d{tmp};
+
+    proc::command_template cmd{target_path, {"--env", "FOO"}, proc::process_env{{"FOO", "TEST-STRING"}}};
+    auto p = cmd.launch(proc::process_io{{}, tmp});
+    p.wait();
+    CHECK(p.exit_code() == 0);
+
+    std::ifstream ifs{tmp};
+    std::string line;
+    CHECK(std::getline(ifs, line));
+    CHECK(line == "TEST-STRING");
+}
+
+#endif
@@ -0,0 +1,77 @@
+#include "doctest.hpp"
+
+#include <filesystem>
+#include <process.hpp>
+
+#include <fstream>
+#include <iterator>
+
+extern std::filesystem::path target_path;
+
+#if defined(__unix__)
+
+TEST_CASE("executable_handle")
+{
+    proc::executable_handle exe{target_path};
+    CHECK(exe.native_handle() != -1);
+
+    std::vector<std::string_view> args{"--exit-code", "42"};
+    for (int i = 0; i < 2; i++)
+    {
+        auto p = proc::default_process_launcher{}.launch(exe, args);
+        p.wait();
+        CHECK(p.exit_code() == 42);
+    }
+
+    auto p1 = proc::clone3_process_launcher{}.launch(exe, args);
+    p1.wait();
+    CHECK(p1.exit_code() == 42);
+
+    auto p2 = proc::spawn_process_launcher{}.launch(exe, args);
+    p2.wait();
+    CHECK(p2.exit_code() == 42);
+
+    auto ps = proc::default_process_launcher{}.launch_many(exe, args, 3u);
+    for (auto & p : ps)
+    {
+        p.wait();
+        CHECK(p.exit_code() == 42);
+    }
+
+    CHECK_THROWS_AS(proc::executable_handle{target_path / "does-not-exist"}, proc::process_error);
+}
+
+TEST_CASE("executable_handle_replaced")
+{
+    const auto tmp = std::filesystem::temp_directory_path() / "proc_executable_handle_test";
+    std::filesystem::remove(tmp);
+    std::filesystem::copy_file(target_path, tmp);
+
+    proc::executable_handle exe{tmp};
+    std::filesystem::remove(tmp);
+
+    // the file is gone, but the handle still refers to it
+    auto p = proc::default_process_launcher{}.launch(exe, std::vector<std::string_view>{"--exit-code", "7"});
+    p.wait();
+    CHECK(p.exit_code() == 7);
+}
+
+TEST_CASE("executable_handle_from_memory")
+{
+    std::ifstream ifs{target_path, std::ios::binary};
+    std::vector<char> data{std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+    REQUIRE(!data.empty());
+
+    auto exe = proc::executable_handle::from_memory(std::as_bytes(std::span(data)), "embedded-target");
+    CHECK(exe.path() == "embedded-target");
+    data.clear(); // the image is copied
+
+    for (int i = 0; i < 2; i++)
+    {
+        auto p = proc::default_process_launcher{}.launch(exe, std::vector<std::string_view>{"--exit-code", "5"});
+        p.wait();
+        CHECK(p.exit_code() == 5);
+    }
+}
+
+#endif
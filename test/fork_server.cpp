@@ -0,0 +1,100 @@
+#include "doctest.hpp"
+
+#include <filesystem>
+#include <process.hpp>
+
+#include <iostream>
+#include <fstream>
+
+extern std::filesystem::path target_path;
+
+#if defined(__unix__)
+
+struct deleter
+{
+    const std::filesystem::path & pt;
+    deleter(const std::filesystem::path & pt) : pt(pt) {}
+    ~deleter()
+    {
+        std::filesystem::remove(pt);
+    }
+};
+
+TEST_CASE("fork_server")
+{
+    proc::fork_server server;
+    CHECK(server.id() > 0);
+
+    SUBCASE("exit_code")
+    {
+        std::vector<std::string_view> args = {"--exit-code", "42", "--wait", "50"};
+        auto proc1 = proc::fork_server_launcher{server}.launch(target_path, args);
+        CHECK(proc1.running());
+        proc1.wait();
+        CHECK(!proc1.running());
+        CHECK(proc1.exit_code() == 42);
+    }
+
+    SUBCASE("error")
+    {
+        std::vector<std::string_view> args;
+        CHECK_THROWS_AS(proc::fork_server_launcher{server}.launch(target_path / "does-not-exist", args), proc::process_error);
+    }
+
+    SUBCASE("io_cwd")
+    {
+        const auto tmp = std::filesystem::temp_directory_path() / "std_process_tmp_file";
+        deleter d{tmp};
+
+        std::vector<std::string_view> args = {"--cwd"};
+        auto p = proc::fork_server_launcher{server}.launch(std::filesystem::absolute(target_path), args,
+                                                           proc::process_io{{}, tmp},
+                                                           proc::process_start_dir(std::filesystem::temp_directory_path()));
+        p.wait();
+        CHECK(p.exit_code() == 0);
+
+        std::ifstream ifs{tmp};
+        CHECK(ifs);
+        std::string line;
+
+        CHECK(std::getline(ifs, line));
+        CHECK(line == std::filesystem::temp_directory_path().string());
+    }
+
+    SUBCASE("async_wait")
+    {
+        std::vector<std::string_view> args = {"--exit-code", "40", "--wait", "50"};
+        auto proc1 = proc::fork_server_launcher{server}.launch(target_path, args);
+
+        int code = -1;
+        asio::io_context ioc;
+        proc1.async_wait(ioc, [&](std::error_code ec, int c)
+        {
+            CHECK(!ec);
+            code = c;
+        });
+        ioc.run();
+        CHECK(code == 40);
+        CHECK(!proc1.running());
+    }
+
+    SUBCASE("group")
+    {
+        proc::process_group gp;
+        std::vector<std::string_view> args = {"--wait", "10000"};
+        auto pid = gp.emplace(target_path, args, proc::fork_server_launcher{server});
+        CHECK(gp.contains(pid));
+        gp.terminate();
+    }
+
+    SUBCASE("terminate")
+    {
+        std::vector<std::string_view> args = {"--wait", "10000"};
+        auto proc1 = proc::fork_server_launcher{server}.launch(target_path, args);
+        proc1.terminate();
+        proc1.wait();
+        CHECK(proc1.exit_code() == SIGKILL);
+    }
+}
+
+#endif
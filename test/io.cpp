@@ -77,3 +77,33 @@ TEST_CASE("stderr_path")
     REQUIRE(std::getline(ifs, line));
     REQUIRE(line == "some message sent to the the stream");
 }
+
+TEST_CASE("argv_marshalling")
+{
+    const auto tmp = std::filesystem::temp_directory_path() / "std_process_tmp_file";
+    deleter d{tmp};
+
+    // Arguments that aren't null terminated on their own.
+    const std::string_view packed = "--outsliced-argument--exit-code42";
+    std::vector<std::string_view> args{packed.substr(0, 5), packed.substr(5, 15), packed.substr(20, 11), packed.substr(31)};
+
+    proc::process p (target_path, args, proc::process_io{.out = tmp});
+    p.wait();
+    CHECK(p.exit_code() == 42);
+
+    std::ifstream ifs{tmp};
+    std::string line;
+    CHECK(std::getline(ifs, line));
+    CHECK(line == "sliced-argument");
+
+    // Too large for the internal buffer.
+    const std::string large(4096, 'x');
+    std::vector<std::string> large_args{"--out", large};
+    proc::process p2 (target_path, large_args, proc::process_io{.out = tmp});
+    p2.wait();
+    CHECK(p2.exit_code() == 0);
+
+    std::ifstream ifs2{tmp};
+    CHECK(std::getline(ifs2, line));
+    CHECK(line == large);
+}
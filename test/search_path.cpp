@@ -0,0 +1,50 @@
+#include "doctest.hpp"
+
+#include <filesystem>
+#include <process.hpp>
+
+#include <cstdlib>
+
+extern std::filesystem::path target_path;
+
+#if defined(__unix__)
+
+TEST_CASE("search_path")
+{
+    const auto sh = proc::search_path("sh");
+    CHECK(sh.is_absolute());
+    CHECK(sh.filename() == "sh");
+    CHECK(proc::search_path("sh") == sh);
+    CHECK(proc::search_path("proc-test-does-not-exist").empty());
+
+    proc::process p("sh", {"-c", "exit 3"});
+    p.wait();
+    CHECK(p.exit_code() == 3);
+}
+
+TEST_CASE("search_path_invalidation")
+{
+    const auto dir = std::filesystem::temp_directory_path() / "proc_search_path_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+
+    const std::string old_path = ::getenv("PATH");
+    ::setenv("PATH", (dir.string() + ":" + old_path).c_str(), 1);
+
+    CHECK(proc::search_path("proc-test-target").empty());
+
+    std::filesystem::copy_file(target_path, dir / "proc-test-target");
+    CHECK(proc::search_path("proc-test-target") == dir / "proc-test-target");
+
+    proc::process p("proc-test-target", {"--exit-code", "42"});
+    p.wait();
+    CHECK(p.exit_code() == 42);
+
+    std::filesystem::remove(dir / "proc-test-target");
+    CHECK(proc::search_path("proc-test-target").empty());
+
+    ::setenv("PATH", old_path.c_str(), 1);
+    std::filesystem::remove_all(dir);
+}
+
+#endif
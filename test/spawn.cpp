@@ -0,0 +1,85 @@
+#include "doctest.hpp"
+
+#include <filesystem>
+#include <process.hpp>
+
+#include <iostream>
+#include <fstream>
+
+extern std::filesystem::path target_path;
+
+struct deleter
+{
+    const std::filesystem::path & pt;
+    deleter(const std::filesystem::path & pt) : pt(pt) {}
+    ~deleter()
+    {
+        std::filesystem::remove(pt);
+    }
+};
+
+// only provides on_exec_setup, so the spawn launcher needs to fork.
+struct exec_chdir
+{
+    std::filesystem::path dir;
+    template <class PosixExecutor>
+    void on_exec_setup(PosixExecutor&) const
+    {
+        ::chdir(dir.c_str());
+    }
+};
+
+TEST_CASE("spawn_exit_code")
+{
+    std::vector<std::string_view> args = {"--exit-code", "42"};
+    auto proc1 = proc::spawn_process_launcher{}.launch(target_path, args);
+    proc1.wait();
+    CHECK(!proc1.running());
+    CHECK(proc1.exit_code() == 42);
+}
+
+TEST_CASE("spawn_error")
+{
+    std::vector<std::string_view> args;
+    CHECK_THROWS_AS(proc::spawn_process_launcher{}.launch(target_path / "does-not-exist", args), proc::process_error);
+}
+
+TEST_CASE("spawn_io_cwd")
+{
+    const auto tmp = std::filesystem::temp_directory_path() / "std_process_tmp_file";
+    deleter d{tmp};
+
+    std::vector<std::string_view> args = {"--cwd"};
+    auto p = proc::spawn_process_launcher{}.launch(std::filesystem::absolute(target_path), args,
+                                                   proc::process_io{{}, tmp},
+                                                   proc::process_start_dir(std::filesystem::temp_directory_path()));
+    p.wait();
+    CHECK(p.exit_code() == 0);
+
+    std::ifstream ifs{tmp};
+    CHECK(ifs);
+    std::string line;
+
+    CHECK(std::getline(ifs, line));
+    CHECK(line == std::filesystem::temp_directory_path().string());
+}
+
+TEST_CASE("spawn_fork_fallback")
+{
+    const auto tmp = std::filesystem::temp_directory_path() / "std_process_tmp_file";
+    deleter d{tmp};
+
+    std::vector<std::string_view> args = {"--cwd"};
+    auto p = proc::spawn_process_launcher{}.launch(std::filesystem::absolute(target_path), args,
+                                                   proc::process_io{{}, tmp},
+                                                   exec_chdir{std::filesystem::temp_directory_path()});
+    p.wait();
+    CHECK(p.exit_code() == 0);
+
+    std::ifstream ifs{tmp};
+    CHECK(ifs);
+    std::string line;
+
+    CHECK(std::getline(ifs, line));
+    CHECK(line == std::filesystem::temp_directory_path().string());
+}
@@ -58,4 +58,69 @@ TEST_CASE("async_wait")
     CHECK(std::chrono::duration_cast<std::chrono::milliseconds>(after - before).count() >= 100);
     CHECK(done);
     CHECK(did_something_else);
-}
\ No newline at end of file
+}
+TEST_CASE("async_wait_many")
+{
+    std::vector<proc::process> procs;
+    for (int i = 0; i < 8; i++)
+        procs.emplace_back(target_path, std::vector<std::string>{"--exit-code", std::to_string(i), "--wait", "50"});
+
+    std::vector<int> codes(procs.size(), -1);
+    asio::io_context ioc;
+    for (std::size_t i = 0u; i < procs.size(); i++)
+        procs[i].async_wait(ioc, [&, i](std::error_code ec, int code) {
+            CHECK(!ec);
+            codes[i] = code;
+        });
+
+    ioc.run();
+    for (std::size_t i = 0u; i < procs.size(); i++)
+    {
+        CHECK(!procs[i].running());
+        CHECK(codes[i] == static_cast<int>(i));
+    }
+}
+
+#if defined(__unix__)
+TEST_CASE("child_reaper")
+{
+    namespace posix = proc::detail::process::posix;
+    proc::process proc1{target_path, {"--exit-code", "39", "--wait", "100"}};
+
+    asio::io_context ioc;
+    auto & service = posix::use_sigchld_service(ioc.get_executor());
+    service.listen(ioc.get_executor());
+
+    int status = -1;
+    auto & reaper = posix::child_reaper::instance();
+    reaper.async_wait(proc1.id(), [&](std::error_code ec, int st)
+    {
+        CHECK(!ec);
+        status = st;
+        service.done();
+    });
+    reaper.reap();
+    ioc.run();
+
+    CHECK(WIFEXITED(status));
+    CHECK(WEXITSTATUS(status) == 39);
+    // the status got reaped by the reaper & gets picked up from it.
+    CHECK(!proc1.running());
+    CHECK(proc1.exit_code() == 39);
+}
+#endif
+
+#if defined(__unix__)
+TEST_CASE("launch_many")
+{
+    auto procs = proc::launch_many(target_path, {"--exit-code", "38", "--wait", "50"}, 16);
+    CHECK(procs.size() == 16u);
+    for (auto & p : procs)
+    {
+        p.wait();
+        CHECK(p.exit_code() == 38);
+    }
+
+    CHECK_THROWS_AS(proc::launch_many(target_path / "does-not-exist", {"--exit-code", "38"}, 4), proc::process_error);
+}
+#endif